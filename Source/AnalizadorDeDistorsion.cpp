@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    AnalizadorDeDistorsion.cpp
+
+  ==============================================================================
+*/
+
+#include "AnalizadorDeDistorsion.h"
+
+void AnalizadorDeDistorsion::prepare()
+{
+    if (motor != nullptr)
+        return;
+
+    motor = creaMotorFFT(ordenFFT);
+
+    const auto N = motor->getSize();
+
+    //HFT95 (Heinzel, Rdiger y Schilling), periodica
+    const std::array<double, 5> c{ 1.0, -1.9383379, 1.3045202, -0.4028270, 0.0350665 };
+
+    ventana.resize((size_t)N);
+    double sumaCuadrados = 0.0;
+
+    for (int n = 0; n < N; ++n)
+    {
+        const auto x = juce::MathConstants<double>::twoPi * double(n) / double(N);
+
+        double w = 0.0;
+        for (size_t k = 0; k < c.size(); ++k)
+            w += c[k] * std::cos(double(k) * x);
+
+        ventana[(size_t)n] = (float)w;
+        sumaCuadrados += w * w;
+    }
+
+    normalizacion = float(2.0 / (double(N) * sumaCuadrados));
+    datos.assign((size_t)N * 2, 0.f);
+}
+
+float AnalizadorDeDistorsion::potenciaDelLobulo(int pico) const
+{
+    const auto numBins = motor->getSize() / 2;
+    const auto desde = juce::jmax(1, pico - binsDelLobulo);
+    const auto hasta = juce::jmin(numBins - 1, pico + binsDelLobulo);
+
+    auto suma = 0.f;
+    for (int k = desde; k <= hasta; ++k)
+        suma += datos[(size_t)k];
+
+    return suma * normalizacion;
+}
+
+float AnalizadorDeDistorsion::binCentroide(int pico) const
+{
+    const auto numBins = motor->getSize() / 2;
+    const auto desde = juce::jmax(1, pico - binsDelLobulo);
+    const auto hasta = juce::jmin(numBins - 1, pico + binsDelLobulo);
+
+    auto suma = 0.f, momento = 0.f;
+    for (int k = desde; k <= hasta; ++k)
+    {
+        suma += datos[(size_t)k];
+        momento += float(k) * datos[(size_t)k];
+    }
+
+    return suma > 0.f ? momento / suma : float(pico);
+}
+
+int AnalizadorDeDistorsion::buscaPico(float binEsperado, int radio) const
+{
+    const auto numBins = motor->getSize() / 2;
+    const auto centro = juce::roundToInt(binEsperado);
+    const auto desde = juce::jlimit(1, numBins - 1, centro - radio);
+    const auto hasta = juce::jlimit(1, numBins - 1, centro + radio);
+
+    auto pico = desde;
+    for (int k = desde + 1; k <= hasta; ++k)
+        if (datos[(size_t)k] > datos[(size_t)pico])
+            pico = k;
+
+    return pico;
+}
+
+ResultadoDeDistorsion AnalizadorDeDistorsion::process(const float* muestras, double sampleRate, float frecuenciaEsperada)
+{
+    jassert(motor != nullptr);
+
+    ResultadoDeDistorsion resultado;
+
+    const auto N = motor->getSize();
+    const auto numBins = N / 2;
+    const auto binWidth = float(sampleRate / double(N));
+
+    juce::FloatVectorOperations::multiply(datos.data(), muestras, ventana.data(), N);
+    std::fill(datos.begin() + N, datos.end(), 0.f);
+
+    motor->transformadaSoloPotencia(datos.data());
+
+    //el fundamental, dentro de un 10% de lo esperado
+    const auto pico = buscaPico(frecuenciaEsperada / binWidth,
+        juce::jmax(binsDelLobulo, juce::roundToInt(0.1f * frecuenciaEsperada / binWidth)));
+
+    const auto potenciaFundamental = potenciaDelLobulo(pico);
+
+    resultado.fundamentalDbFS = 10.f * std::log10(juce::jmax(2.f * potenciaFundamental, 1.0e-20f));
+
+    if (resultado.fundamentalDbFS < umbralFundamentalDbFS)
+        return resultado;
+
+    const auto binFundamental = binCentroide(pico);
+    resultado.fundamentalHz = binFundamental * binWidth;
+
+    //armonicos: el pico mas alto a 2 bins de h * f0, con f0 ya interpolado
+    auto potenciaArmonicos = 0.f;
+
+    for (int h = 2; h < 2 + ResultadoDeDistorsion::maxArmonicos; ++h)
+    {
+        const auto binEsperado = float(h) * binFundamental;
+
+        if (binEsperado + float(binsDelLobulo) >= float(numBins))
+            break;
+
+        const auto potencia = potenciaDelLobulo(buscaPico(binEsperado, 2));
+
+        resultado.armonicosDb[(size_t)resultado.numArmonicos++] =
+            10.f * std::log10(juce::jmax(potencia / potenciaFundamental, 1.0e-20f));
+
+        potenciaArmonicos += potencia;
+    }
+
+    //THD+N: todo lo que hay en la banda menos el lobulo del fundamental (y el DC, que queda fuera)
+    const auto primerBin = juce::jmax(1, (int)std::ceil(frecuenciaMinima / binWidth));
+    const auto ultimoBin = juce::jmin(numBins - 1, (int)std::floor(frecuenciaMaxima / binWidth));
+
+    auto potenciaResto = 0.f;
+    for (int k = primerBin; k <= ultimoBin; ++k)
+        if (std::abs(k - pico) > binsDelLobulo)
+            potenciaResto += datos[(size_t)k];
+
+    potenciaResto *= normalizacion;
+
+    const auto thd = potenciaArmonicos / potenciaFundamental;
+    const auto thdn = potenciaResto / potenciaFundamental;
+
+    resultado.thdPorCiento = 100.f * std::sqrt(thd);
+    resultado.thdDb = 10.f * std::log10(juce::jmax(thd, 1.0e-20f));
+    resultado.thdnPorCiento = 100.f * std::sqrt(thdn);
+    resultado.thdnDb = 10.f * std::log10(juce::jmax(thdn, 1.0e-20f));
+
+    resultado.valido = true;
+    return resultado;
+}
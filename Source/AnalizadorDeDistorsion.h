@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    AnalizadorDeDistorsion.h
+
+    THD, THD+N y nivel de cada armonico de un tono de prueba. Se usa una
+    ventana flat-top (HFT95): su lobulo principal es ancho, pero plano, asi
+    que el nivel de un tono no depende de donde caiga entre dos bins, y sus
+    lobulos laterales quedan 95 dB por debajo, lo bastante para medir el
+    ruido y los armonicos cerca del fundamental.
+
+    La frecuencia del fundamental se interpola con el centroide de potencia
+    de su lobulo, y cada armonico se busca alrededor de su multiplo exacto,
+    no del bin redondeado.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "MotorFFT.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+struct ResultadoDeDistorsion
+{
+    static constexpr int maxArmonicos = 9;   //del 2 al 10
+
+    bool valido = false;
+
+    float fundamentalHz = 0.f, fundamentalDbFS = -200.f;
+
+    //relativos al fundamental, dBc; solo los numArmonicos primeros caen por debajo de Nyquist
+    std::array<float, maxArmonicos> armonicosDb{};
+    int numArmonicos = 0;
+
+    float thdPorCiento = 0.f, thdDb = -200.f;
+    float thdnPorCiento = 0.f, thdnDb = -200.f;
+};
+
+struct AnalizadorDeDistorsion
+{
+    static constexpr int ordenFFT = 16;
+
+    //bins a cada lado del pico que se cuentan como parte de un tono: HFT95 tiene 5 cosenos, su lobulo principal llega a +-5 bins
+    static constexpr int binsDelLobulo = 5;
+
+    //el THD+N se mide en la banda de audio, como un analizador con filtro de 20 Hz - 20 kHz
+    static constexpr float frecuenciaMinima = 20.f, frecuenciaMaxima = 20000.f;
+
+    //por debajo de esto no hay tono que medir
+    static constexpr float umbralFundamentalDbFS = -100.f;
+
+    void prepare();
+
+    int getFFTSize() const { return motor != nullptr ? motor->getSize() : 0; }
+
+    //'muestras' tiene getFFTSize() muestras; el tono se busca cerca de 'frecuenciaEsperada'
+    ResultadoDeDistorsion process(const float* muestras, double sampleRate, float frecuenciaEsperada);
+private:
+    //potencia cuadratica media del tono cuyo lobulo esta centrado en 'pico'
+    float potenciaDelLobulo(int pico) const;
+    float binCentroide(int pico) const;
+    int buscaPico(float binEsperado, int radio) const;
+
+    std::unique_ptr<MotorFFT> motor;
+    std::vector<float> ventana, datos;
+
+    //pasa de suma de |X|^2 a potencia cuadratica media: 2 / (N * sum(w^2))
+    float normalizacion = 1.f;
+};
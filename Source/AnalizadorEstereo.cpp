@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    AnalizadorEstereo.cpp
+
+  ==============================================================================
+*/
+
+#include "AnalizadorEstereo.h"
+
+void AnalizadorEstereo::prepare(int ordenFFT)
+{
+    if (fft != nullptr && fft->getSize() == (1 << ordenFFT))
+        return;
+
+    fft = std::make_unique<juce::dsp::FFT>(ordenFFT);
+
+    const auto N = fft->getSize();
+
+    //la misma ventana que la traza en vivo, para que M y S se lean en su escala
+    ventana.resize((size_t)N);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(ventana.data(), (size_t)N,
+        juce::dsp::WindowingFunction<float>::blackmanHarris, true);
+
+    tiempo.assign((size_t)N, {});
+    frecuencia.assign((size_t)N, {});
+
+    for (auto* espectro : { &gmm, &gss, &gll, &grr, &glrRe, &glrIm })
+        espectro->assign((size_t)N / 2, 0.f);
+
+    numPromedios = 0;
+}
+
+void AnalizadorEstereo::reinicia()
+{
+    for (auto* espectro : { &gmm, &gss, &gll, &grr, &glrRe, &glrIm })
+        std::fill(espectro->begin(), espectro->end(), 0.f);
+
+    numPromedios = 0;
+}
+
+void AnalizadorEstereo::process(const float* izquierdo, const float* derecho, float alfa)
+{
+    jassert(fft != nullptr);
+
+    const auto N = fft->getSize();
+    const auto numBins = N / 2;
+
+    //M/S y ventana en la misma pasada: z = w (L + R) / 2 + j w (L - R) / 2
+    for (int n = 0; n < N; ++n)
+    {
+        const auto w = 0.5f * ventana[(size_t)n];
+        tiempo[(size_t)n] = { w * (izquierdo[n] + derecho[n]), w * (izquierdo[n] - derecho[n]) };
+    }
+
+    fft->perform(tiempo.data(), frecuencia.data(), false);
+
+    ++numPromedios;
+    const auto peso = juce::jmax(alfa, 1.f / float(numPromedios));
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const auto z = frecuencia[(size_t)k];
+        const auto zEspejo = std::conj(frecuencia[(size_t)((N - k) % N)]);
+
+        //M = (Z[k] + conj(Z[N-k])) / 2,  S = (Z[k] - conj(Z[N-k])) / 2j
+        const auto M = 0.5f * (z + zEspejo);
+        const auto S = juce::dsp::Complex<float>(0.f, -0.5f) * (z - zEspejo);
+
+        const auto L = M + S;
+        const auto R = M - S;
+        const auto cruzado = L * std::conj(R);
+
+        gmm[(size_t)k] += peso * (std::norm(M) - gmm[(size_t)k]);
+        gss[(size_t)k] += peso * (std::norm(S) - gss[(size_t)k]);
+        gll[(size_t)k] += peso * (std::norm(L) - gll[(size_t)k]);
+        grr[(size_t)k] += peso * (std::norm(R) - grr[(size_t)k]);
+        glrRe[(size_t)k] += peso * (cruzado.real() - glrRe[(size_t)k]);
+        glrIm[(size_t)k] += peso * (cruzado.imag() - glrIm[(size_t)k]);
+    }
+}
+
+float AnalizadorEstereo::getCorrelacionGlobal() const
+{
+    double sumaLl = 0.0, sumaRr = 0.0, sumaLr = 0.0;
+
+    //sin el DC, que no es parte de la imagen estereo
+    for (size_t k = 1; k < gll.size(); ++k)
+    {
+        sumaLl += gll[k];
+        sumaRr += grr[k];
+        sumaLr += glrRe[k];
+    }
+
+    const auto denominador = std::sqrt(sumaLl * sumaRr);
+
+    return denominador > 0.0 ? juce::jlimit(-1.f, 1.f, float(sumaLr / denominador)) : 0.f;
+}
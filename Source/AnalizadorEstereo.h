@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    AnalizadorEstereo.h
+
+    Imagen estereo de la salida a partir de una sola FFT compleja por trama.
+    Al enventanar se pasa de L/R a medio y lado, M = (L + R) / 2 y
+    S = (L - R) / 2, y van juntos como z = M + j S. Por simetria salen los
+    espectros de M y de S, y como L = M + S y R = M - S, tambien el espectro
+    cruzado de L y R sin ninguna transformada mas.
+
+    Por bin se promedian |M|^2, |S|^2, |L|^2, |R|^2 y L R*. De ahi salen la
+    correlacion Re(Glr) / sqrt(Gll Grr), entre -1 (fase opuesta) y +1
+    (mono), y la coherencia |Glr|^2 / (Gll Grr), que dice si la relacion
+    entre los canales es estable aunque la fase no sea cero.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <memory>
+#include <vector>
+
+//lo que se dibuja de la correlacion, un valor por columna de pixeles
+struct MedidaEstereo
+{
+    std::vector<float> correlacion, coherencia;
+    float correlacionGlobal = 0.f;
+};
+
+struct AnalizadorEstereo
+{
+    void prepare(int ordenFFT);
+
+    int getFFTSize() const { return fft != nullptr ? fft->getSize() : 0; }
+    int getNumBins() const { return getFFTSize() / 2; }
+
+    void reinicia();
+
+    /*
+     adds one frame of getFFTSize() samples of each channel. 'alfa' is the weight of the new
+     frame in the exponential average; the first 1 / alfa frames are averaged linearly.
+     */
+    void process(const float* izquierdo, const float* derecho, float alfa);
+
+    /*
+     correlation over the whole band from the averaged spectra, the same number a correlation
+     meter gives in the time domain (Parseval), but weighted by the window.
+     */
+    float getCorrelacionGlobal() const;
+
+    //promedios por bin; M y S con la escala de la traza en vivo (ventana normalizada a media 1)
+    const std::vector<float>& getPotenciaMedio() const { return gmm; }
+    const std::vector<float>& getPotenciaLado() const { return gss; }
+    const std::vector<float>& getGll() const { return gll; }
+    const std::vector<float>& getGrr() const { return grr; }
+    const std::vector<float>& getGlrRe() const { return glrRe; }
+    const std::vector<float>& getGlrIm() const { return glrIm; }
+private:
+    std::unique_ptr<juce::dsp::FFT> fft;
+
+    std::vector<float> ventana;
+    std::vector<juce::dsp::Complex<float>> tiempo, frecuencia;
+
+    std::vector<float> gmm, gss, gll, grr, glrRe, glrIm;
+    int numPromedios = 0;
+};
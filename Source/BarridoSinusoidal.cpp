@@ -0,0 +1,269 @@
+/*
+  ==============================================================================
+
+    BarridoSinusoidal.cpp
+
+  ==============================================================================
+*/
+
+#include "BarridoSinusoidal.h"
+
+void BarridoSinusoidal::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    const juce::ScopedLock sl(lock);
+
+    osc.initialise([](float x) { return std::sin(x); });
+    osc.prepare(spec);
+
+    frecuencia = spec.sampleRate;
+    ganancia = juce::Decibels::decibelsToGain(nivelDb);
+
+    //los canales del bus y, al final, la excitacion
+    grabacion.setSize((int)spec.numChannels + 1,
+        muestrasGrabadas,
+        false,   //keepExistingContent
+        true,    //clear extra space
+        true);   //avoid reallocating
+
+    estado.store(Estado::Parada);
+    progreso.store(0.f);
+}
+
+void BarridoSinusoidal::inicia(DestinoBarrido destino)
+{
+    const juce::ScopedLock sl(lock);
+
+    destinoPedido.store(destino);
+    progreso.store(0.f);
+    estado.store(Estado::Armada);
+}
+
+void BarridoSinusoidal::cancela()
+{
+    const juce::ScopedLock sl(lock);
+    estado.store(Estado::Parada);
+}
+
+void BarridoSinusoidal::iniciaTono(DestinoBarrido destino)
+{
+    destinoTonoPedido.store(destino);
+    tonoPedido.store(true);
+}
+
+void BarridoSinusoidal::antesDeLaCadena(juce::AudioBuffer<float>& buffer)
+{
+    auto armada = Estado::Armada;
+
+    if (estado.compare_exchange_strong(armada, Estado::Midiendo))
+    {
+        destinoEnCurso = destinoPedido.load();
+        posicion = 0;
+
+        //f(n) = f0 * (f1 / f0)^(n / N), un paso multiplicativo por muestra
+        const auto frecuenciaFinal = getFrecuenciaFinal(frecuencia);
+        frecuenciaActual = frecuenciaInicial;
+        razonPorMuestra = std::exp(std::log(double(frecuenciaFinal) / double(frecuenciaInicial)) / double(muestrasBarrido));
+
+        osc.reset();
+    }
+
+    if (estado.load() != Estado::Midiendo)
+    {
+        //el tono arranca en fase cero, asi empieza en silencio y sin click
+        if (tonoPedido.load() && !tonoEnCurso)
+        {
+            osc.reset();
+            osc.setFrequency(frecuenciaTono, true);
+        }
+
+        tonoEnCurso = tonoPedido.load();
+        destinoDelTono = destinoTonoPedido.load();
+
+        if (tonoSonando(Barrido_Cadena))
+            escribeTono(buffer);
+
+        return;
+    }
+
+    //el barrido usa el oscilador, el tono se vuelve a empezar al terminar
+    tonoEnCurso = false;
+
+    muestrasDelBloque = juce::jmin(buffer.getNumSamples(), muestrasGrabadas - posicion);
+
+    if (destinoEnCurso == Barrido_Cadena)
+        escribeExcitacion(buffer);
+    else
+        grabaRespuesta(buffer);
+}
+
+void BarridoSinusoidal::despuesDeLaCadena(juce::AudioBuffer<float>& buffer)
+{
+    if (tonoSonando(Barrido_Externo))
+        escribeTono(buffer);
+
+    if (estado.load() != Estado::Midiendo)
+        return;
+
+    if (destinoEnCurso == Barrido_Cadena)
+        grabaRespuesta(buffer);
+    else
+        escribeExcitacion(buffer);
+
+    posicion += muestrasDelBloque;
+    progreso.store(float(posicion) / float(muestrasGrabadas));
+
+    //si entretanto se cancelo o se volvio a armar, esta grabacion ya no vale
+    auto midiendo = Estado::Midiendo;
+    if (posicion >= muestrasGrabadas)
+        estado.compare_exchange_strong(midiendo, Estado::Grabada);
+}
+
+void BarridoSinusoidal::escribeExcitacion(juce::AudioBuffer<float>& buffer)
+{
+    auto* excitacion = grabacion.getWritePointer(grabacion.getNumChannels() - 1, posicion);
+
+    //el final del barrido se apaga con medio coseno, sin un corte brusco en agudos
+    constexpr int muestrasDeCaida = muestrasBarrido / 64;
+    constexpr int inicioDeCaida = muestrasBarrido - muestrasDeCaida;
+
+    for (int i = 0; i < muestrasDelBloque; ++i)
+    {
+        const auto n = posicion + i;
+
+        if (n >= muestrasBarrido)
+        {
+            excitacion[i] = 0.f;
+            continue;
+        }
+
+        osc.setFrequency((float)frecuenciaActual, true);
+        frecuenciaActual *= razonPorMuestra;
+
+        auto envolvente = ganancia;
+        if (n >= inicioDeCaida)
+            envolvente *= 0.5f + 0.5f * std::cos(juce::MathConstants<float>::pi * float(n - inicioDeCaida) / float(muestrasDeCaida));
+
+        excitacion[i] = envolvente * osc.processSample(0.f);
+    }
+
+    for (int canal = 0; canal < buffer.getNumChannels(); ++canal)
+        buffer.copyFrom(canal, 0, excitacion, muestrasDelBloque);
+}
+
+void BarridoSinusoidal::escribeTono(juce::AudioBuffer<float>& buffer)
+{
+    const auto numMuestras = buffer.getNumSamples();
+    auto* tono = buffer.getWritePointer(0);
+
+    for (int i = 0; i < numMuestras; ++i)
+        tono[i] = ganancia * osc.processSample(0.f);
+
+    for (int canal = 1; canal < buffer.getNumChannels(); ++canal)
+        buffer.copyFrom(canal, 0, tono, numMuestras);
+}
+
+void BarridoSinusoidal::grabaRespuesta(const juce::AudioBuffer<float>& buffer)
+{
+    const auto numCanales = juce::jmin(grabacion.getNumChannels() - 1, buffer.getNumChannels());
+
+    for (int canal = 0; canal < numCanales; ++canal)
+        grabacion.copyFrom(canal, posicion, buffer, canal, 0, muestrasDelBloque);
+}
+
+bool BarridoSinusoidal::copia(juce::AudioBuffer<float>& destino, double& sampleRate)
+{
+    const juce::ScopedLock sl(lock);
+
+    if (!hayGrabacion())
+        return false;
+
+    destino.makeCopyOf(grabacion, true);
+    sampleRate = frecuencia;
+    return true;
+}
+
+//==============================================================================
+void DeconvolucionDeBarrido::prepare(const float* excitacion, double sampleRate)
+{
+    if (fft == nullptr)
+        fft = std::make_unique<juce::dsp::FFT>(ordenFFT);
+
+    const auto N = fft->getSize();
+    const auto S = BarridoSinusoidal::muestrasBarrido;
+
+    const auto frecuenciaInicial = double(BarridoSinusoidal::frecuenciaInicial);
+    const auto frecuenciaFinal = double(BarridoSinusoidal::getFrecuenciaFinal(sampleRate));
+
+    //muestras que tarda la frecuencia en multiplicarse por e
+    const auto L = double(S) / std::log(frecuenciaFinal / frecuenciaInicial);
+
+    espectroInverso.assign((size_t)N * 2, 0.f);
+    datos.assign((size_t)N * 2, 0.f);
+
+    //el barrido al reves empieza en agudos; la envolvente baja 6 dB/oct para compensar su espectro rosa
+    for (int n = 0; n < S; ++n)
+        espectroInverso[(size_t)n] = excitacion[S - 1 - n] * (float)std::exp(-double(n) / L);
+
+    std::copy(excitacion, excitacion + S, datos.begin());
+
+    fft->performRealOnlyForwardTransform(espectroInverso.data(), true);
+    fft->performRealOnlyForwardTransform(datos.data(), true);
+
+    //normalizamos con la media de |barrido * inverso| dentro de la banda, lejos de los bordes
+    const auto binWidth = sampleRate / double(N);
+    const auto primerBin = juce::jmax(1, (int)std::ceil(2.0 * frecuenciaInicial / binWidth));
+    const auto ultimoBin = juce::jmin(N / 2, (int)std::floor(0.5 * frecuenciaFinal / binWidth));
+
+    double suma = 0.0;
+    for (int k = primerBin; k <= ultimoBin; ++k)
+    {
+        const auto producto = std::hypot(double(datos[2 * (size_t)k]), double(datos[2 * (size_t)k + 1]))
+            * std::hypot(double(espectroInverso[2 * (size_t)k]), double(espectroInverso[2 * (size_t)k + 1]));
+        suma += producto;
+    }
+
+    const auto media = suma / double(juce::jmax(1, ultimoBin - primerBin + 1));
+    const auto escala = media > 0.0 ? float(1.0 / media) : 0.f;
+
+    juce::FloatVectorOperations::multiply(espectroInverso.data(), escala, N + 2);
+}
+
+void DeconvolucionDeBarrido::process(const float* respuesta, std::vector<float>& impulso)
+{
+    jassert(fft != nullptr);
+
+    const auto N = fft->getSize();
+
+    std::copy(respuesta, respuesta + BarridoSinusoidal::muestrasGrabadas, datos.begin());
+    std::fill(datos.begin() + BarridoSinusoidal::muestrasGrabadas, datos.end(), 0.f);
+
+    fft->performRealOnlyForwardTransform(datos.data(), true);
+
+    for (int k = 0; k <= N / 2; ++k)
+    {
+        const auto a = juce::dsp::Complex<float>(datos[2 * (size_t)k], datos[2 * (size_t)k + 1]);
+        const auto b = juce::dsp::Complex<float>(espectroInverso[2 * (size_t)k], espectroInverso[2 * (size_t)k + 1]);
+        const auto producto = a * b;
+
+        datos[2 * (size_t)k] = producto.real();
+        datos[2 * (size_t)k + 1] = producto.imag();
+    }
+
+    fft->performRealOnlyInverseTransform(datos.data());
+
+    /*
+     the convolution is circular: what goes past N wraps onto the first muestrasGrabadas +
+     muestrasBarrido - 1 - N samples, where only the harmonic products of high order live.
+     the linear response starts at muestrasBarrido - 1 and stays clear of both.
+     */
+    const auto inicio = BarridoSinusoidal::muestrasBarrido - 1 - muestrasPrevias;
+
+    impulso.assign(datos.begin() + inicio, datos.begin() + inicio + longitudImpulso);
+
+    //el ultimo octavo se apaga, cortar en seco aadiria rizado al modulo
+    const auto muestrasDeCaida = longitudImpulso / 8;
+    const auto inicioDeCaida = longitudImpulso - muestrasDeCaida;
+
+    for (int n = inicioDeCaida; n < longitudImpulso; ++n)
+        impulso[(size_t)n] *= 0.5f + 0.5f * std::cos(juce::MathConstants<float>::pi * float(n - inicioDeCaida) / float(muestrasDeCaida));
+}
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+    BarridoSinusoidal.h
+
+    Medida con un barrido sinusoidal logaritmico. El oscilador genera un
+    barrido de 20 Hz hasta casi Nyquist y el hilo de audio graba la
+    respuesta en un buffer reservado en prepareToPlay. Despues, fuera del
+    hilo de audio, la respuesta se convoluciona con el barrido invertido en
+    el tiempo: queda la respuesta al impulso lineal, y los productos de
+    distorsion armonica caen antes del instante cero, separados de ella.
+
+    El barrido puede pasar por la cadena de filtros (sustituye a la entrada)
+    o salir del plugin hacia un equipo externo, grabando lo que vuelve por
+    la entrada.
+
+    El mismo oscilador da tambien un tono fijo para medir distorsion. Un
+    barrido tiene prioridad: el tono se calla mientras dura y vuelve al
+    terminar.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//lo que se dibuja de una medida
+struct MedidaDelBarrido
+{
+    //modulo en dB por columna de pixeles, un vector por canal del bus
+    std::array<std::vector<float>, 2> respuestaDb;
+
+    //las columnas que caen dentro de la banda barrida, fuera no hay medida
+    int primeraColumna = 0, ultimaColumna = -1;
+
+    //el impulso de un canal alrededor de su pico, normalizado, un minimo y un maximo por columna
+    std::vector<float> impulsoMinimos, impulsoMaximos;
+    float retardoMs = 0.f;
+};
+
+enum DestinoBarrido
+{
+    Barrido_Cadena,
+    Barrido_Externo
+};
+
+struct BarridoSinusoidal
+{
+    static constexpr int muestrasBarrido = 1 << 17;
+    static constexpr int muestrasCola = 1 << 16;
+    static constexpr int muestrasGrabadas = muestrasBarrido + muestrasCola;
+
+    static constexpr float frecuenciaInicial = 20.f;
+    static constexpr float frecuenciaFinalMaxima = 20000.f;
+    static constexpr float nivelDb = -12.f;
+
+    //997 Hz en vez de 1 kHz, como en AES17: los armonicos no caen en multiplos redondos de la frecuencia de muestreo
+    static constexpr float frecuenciaTono = 997.f;
+
+    //hasta donde llega el barrido, siempre por debajo de Nyquist
+    static float getFrecuenciaFinal(double sampleRate)
+    {
+        return juce::jmin(frecuenciaFinalMaxima, float(0.45 * sampleRate));
+    }
+
+    //fuera del hilo de audio (prepareToPlay), reserva la grabacion
+    void prepare(const juce::dsp::ProcessSpec& spec);
+
+    //hilo de mensajes: el hilo de audio empieza la medida en su siguiente bloque
+    void inicia(DestinoBarrido destino);
+    void cancela();
+
+    //hilo de mensajes: el tono suena hacia 'destino' hasta que se llame a paraTono()
+    void iniciaTono(DestinoBarrido destino);
+    void paraTono() { tonoPedido.store(false); }
+
+    /*
+     audio thread, around the filter chain. with Barrido_Cadena the sweep replaces the
+     input before the chain and the chain output is recorded; with Barrido_Externo the
+     input is recorded before the chain and the sweep replaces the output.
+     */
+    void antesDeLaCadena(juce::AudioBuffer<float>& buffer);
+    void despuesDeLaCadena(juce::AudioBuffer<float>& buffer);
+
+    //hilo de audio, despues de antesDeLaCadena: si en este bloque suena el tono hacia 'destino'
+    bool tonoSonando(DestinoBarrido destino) const { return tonoEnCurso && destinoDelTono == destino; }
+
+    bool estaMidiendo() const
+    {
+        auto e = estado.load();
+        return e == Estado::Armada || e == Estado::Midiendo;
+    }
+
+    bool hayGrabacion() const { return estado.load() == Estado::Grabada; }
+    float getProgreso() const { return progreso.load(); }
+
+    /*
+     copies the finished recording into 'destino': one channel per bus channel and, as
+     the last channel, the excitation exactly as it was played. returns false until a
+     recording is complete.
+     */
+    bool copia(juce::AudioBuffer<float>& destino, double& sampleRate);
+private:
+    enum class Estado
+    {
+        Parada,
+        Armada,
+        Midiendo,
+        Grabada
+    };
+
+    void escribeExcitacion(juce::AudioBuffer<float>& buffer);
+    void escribeTono(juce::AudioBuffer<float>& buffer);
+    void grabaRespuesta(const juce::AudioBuffer<float>& buffer);
+
+    juce::dsp::Oscillator<float> osc;
+
+    juce::AudioBuffer<float> grabacion;
+    double frecuencia = 0.0;
+    float ganancia = 1.f;
+
+    //solo los toca el hilo de audio mientras mide
+    DestinoBarrido destinoEnCurso = Barrido_Cadena;
+    int posicion = 0, muestrasDelBloque = 0;
+    double frecuenciaActual = 0.0, razonPorMuestra = 1.0;
+    bool tonoEnCurso = false;
+    DestinoBarrido destinoDelTono = Barrido_Cadena;
+
+    std::atomic<Estado> estado{ Estado::Parada };
+    std::atomic<DestinoBarrido> destinoPedido{ Barrido_Cadena };
+    std::atomic<float> progreso{ 0.f };
+    std::atomic<bool> tonoPedido{ false };
+    std::atomic<DestinoBarrido> destinoTonoPedido{ Barrido_Cadena };
+
+    //prepare, inicia, cancela y copia no pueden cruzarse, el hilo de audio nunca lo toma
+    juce::CriticalSection lock;
+};
+
+/*
+ Farina's inverse filter: the sweep reversed in time with a 6 dB/oct falling envelope, so
+ sweep * inverse is flat over the swept band. the convolution is done with one real FFT
+ of 2^18 points per channel.
+ */
+struct DeconvolucionDeBarrido
+{
+    static constexpr int ordenFFT = 18;
+
+    //muestras que se guardan antes del instante cero, para ver el arranque del impulso
+    static constexpr int muestrasPrevias = 256;
+    static constexpr int ordenImpulso = 16;
+    static constexpr int longitudImpulso = 1 << ordenImpulso;
+    static_assert(longitudImpulso <= BarridoSinusoidal::muestrasCola, "el impulso tiene que caber en la cola grabada");
+
+    //construye el filtro inverso a partir de la excitacion que se emitio de verdad
+    void prepare(const float* excitacion, double sampleRate);
+
+    /*
+     deconvolves BarridoSinusoidal::muestrasGrabadas samples of response. 'impulso' gets
+     longitudImpulso samples of the linear impulse response, starting muestrasPrevias
+     before time zero and faded out at the end.
+     */
+    void process(const float* respuesta, std::vector<float>& impulso);
+private:
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> espectroInverso, datos;
+};
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    CapturaRetroactiva.cpp
+
+  ==============================================================================
+*/
+
+#include "CapturaRetroactiva.h"
+
+void CapturaRetroactiva::prepare(double sampleRate, int numCanales)
+{
+    const juce::ScopedLock sl(lock);
+
+    frecuencia = sampleRate;
+
+    anillo.setSize(numCanales,
+        (int)std::ceil(segundosDeCaptura * sampleRate),
+        false,   //keepExistingContent
+        true,    //clear extra space
+        true);   //avoid reallocating
+
+    posicionEscritura = 0;
+    muestrasValidas = 0;
+}
+
+void CapturaRetroactiva::escribe(const juce::AudioBuffer<float>& buffer, bool despuesDeUnHueco)
+{
+    escribiendo.store(true);
+
+    if (congelada.load())
+    {
+        descartarAlEscribir = true;
+        escribiendo.store(false);
+        return;
+    }
+
+    if (despuesDeUnHueco || descartarAlEscribir)
+    {
+        muestrasValidas = 0;
+        descartarAlEscribir = false;
+    }
+
+    const auto capacidad = anillo.getNumSamples();
+    const auto numCanales = juce::jmin(anillo.getNumChannels(), buffer.getNumChannels());
+
+    //un bloque mayor que el anillo solo deja su final
+    auto numMuestras = buffer.getNumSamples();
+    auto inicio = 0;
+
+    if (numMuestras > capacidad)
+    {
+        inicio = numMuestras - capacidad;
+        numMuestras = capacidad;
+    }
+
+    const auto primerTramo = juce::jmin(numMuestras, capacidad - posicionEscritura);
+
+    for (int canal = 0; canal < numCanales; ++canal)
+    {
+        anillo.copyFrom(canal, posicionEscritura, buffer, canal, inicio, primerTramo);
+
+        if (numMuestras > primerTramo)
+            anillo.copyFrom(canal, 0, buffer, canal, inicio + primerTramo, numMuestras - primerTramo);
+    }
+
+    if (capacidad > 0)
+        posicionEscritura = (posicionEscritura + numMuestras) % capacidad;
+
+    muestrasValidas = juce::jmin(muestrasValidas + numMuestras, capacidad);
+
+    escribiendo.store(false);
+}
+
+void CapturaRetroactiva::descongela()
+{
+    //espera a que termine una copia en curso, el audio vuelve a escribir en cuanto esto baje
+    const juce::ScopedLock sl(lock);
+    congelada.store(false);
+}
+
+bool CapturaRetroactiva::copia(juce::AudioBuffer<float>& destino, double& sampleRate)
+{
+    const juce::ScopedLock sl(lock);
+
+    if (!estaDetenida())
+        return false;
+
+    const auto capacidad = anillo.getNumSamples();
+    const auto inicio = (posicionEscritura - muestrasValidas + capacidad) % juce::jmax(1, capacidad);
+    const auto primerTramo = juce::jmin(muestrasValidas, capacidad - inicio);
+
+    destino.setSize(anillo.getNumChannels(), muestrasValidas, false, false, true);
+
+    for (int canal = 0; canal < anillo.getNumChannels(); ++canal)
+    {
+        destino.copyFrom(canal, 0, anillo, canal, inicio, primerTramo);
+
+        if (muestrasValidas > primerTramo)
+            destino.copyFrom(canal, primerTramo, anillo, canal, 0, muestrasValidas - primerTramo);
+    }
+
+    sampleRate = frecuencia;
+    return true;
+}
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    CapturaRetroactiva.h
+
+    Historial de la entrada del analizador de los ultimos segundos, para
+    poder congelarlo y volver a analizarlo con mucha mas resolucion.
+
+    El hilo de audio escribe en un anillo reservado en prepareToPlay, sin
+    locks. Al congelar deja de escribir y el anillo queda fijo hasta que se
+    descongela, asi que el analisis puede leerlo con calma.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+
+struct CapturaRetroactiva
+{
+    static constexpr double segundosDeCaptura = 20.0;
+
+    //fuera del hilo de audio (prepareToPlay), reserva el anillo
+    void prepare(double sampleRate, int numCanales);
+
+    /*
+     audio thread. 'despuesDeUnHueco' tells that the previous block was not written, so
+     what the ring holds is not contiguous with this one and is forgotten.
+     */
+    void escribe(const juce::AudioBuffer<float>& buffer, bool despuesDeUnHueco);
+
+    //hilo de mensajes
+    void congela() { congelada.store(true); }
+    void descongela();
+    bool estaCongelada() const { return congelada.load(); }
+
+    /*
+     copies everything the frozen ring holds into 'destino', oldest sample first, one channel
+     per ring channel. returns false while the capture is not frozen or the audio thread is
+     still finishing the block it was writing when it was frozen.
+     */
+    bool copia(juce::AudioBuffer<float>& destino, double& sampleRate);
+
+    //solo lee atomicos, se puede preguntar desde el lock del pool
+    bool estaDetenida() const { return congelada.load() && !escribiendo.load(); }
+private:
+    juce::AudioBuffer<float> anillo;
+    int posicionEscritura = 0;
+    int muestrasValidas = 0;
+    double frecuencia = 0.0;
+
+    //solo lo toca el hilo de audio: al descongelar hay que empezar de cero
+    bool descartarAlEscribir = false;
+
+    /*
+     handshake: the audio thread raises 'escribiendo' before looking at 'congelada', and the
+     reader only copies after seeing 'congelada' set and 'escribiendo' down. whichever order
+     they run in, the audio thread either sees the freeze or the reader sees it writing.
+     */
+    std::atomic<bool> congelada{ false }, escribiendo{ false };
+
+    //prepare, descongela y copia no pueden cruzarse, el hilo de audio nunca lo toma
+    juce::CriticalSection lock;
+};
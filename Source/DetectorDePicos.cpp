@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    DetectorDePicos.cpp
+
+  ==============================================================================
+*/
+
+#include "DetectorDePicos.h"
+
+void PicosEspectrales::aade(const PicoEspectral& pico, int limite)
+{
+    limite = juce::jmin(limite, maxPicos);
+
+    int posicion = numPicos;
+    while (posicion > 0 && picos[(size_t)posicion - 1].nivelDb < pico.nivelDb)
+        --posicion;
+
+    if (posicion >= limite)
+        return;
+
+    numPicos = juce::jmin(numPicos + 1, limite);
+
+    for (int i = numPicos - 1; i > posicion; --i)
+        picos[(size_t)i] = picos[(size_t)i - 1];
+
+    picos[(size_t)posicion] = pico;
+}
+
+float DetectorDePicos::getProminencia(const float* datosDb, int numBins, int bin) const
+{
+    const auto altura = datosDb[bin];
+
+    //bajamos hacia cada lado hasta encontrar algo mas alto que el pico o el final de la trama
+    auto valleIzquierdo = altura;
+    for (int k = bin - 1; k >= 0 && datosDb[k] <= altura; --k)
+        valleIzquierdo = juce::jmin(valleIzquierdo, datosDb[k]);
+
+    auto valleDerecho = altura;
+    for (int k = bin + 1; k < numBins && datosDb[k] <= altura; ++k)
+        valleDerecho = juce::jmin(valleDerecho, datosDb[k]);
+
+    return altura - juce::jmax(valleIzquierdo, valleDerecho);
+}
+
+void DetectorDePicos::busca(const float* datosDb,
+    int numBins,
+    float binWidth,
+    float frecuenciaPrimerBin,
+    float desde,
+    float hasta,
+    PicosEspectrales& resultado) const
+{
+    if (numPicos == 0 || numBins < 3 || binWidth <= 0.f)
+        return;
+
+    auto primerBin = juce::jmax(1, (int)std::ceil((desde - frecuenciaPrimerBin) / binWidth));
+    auto ultimoBin = juce::jmin(numBins - 2, (int)std::floor((hasta - frecuenciaPrimerBin) / binWidth));
+
+    for (int k = primerBin; k <= ultimoBin; ++k)
+    {
+        const auto a = datosDb[k - 1];
+        const auto b = datosDb[k];
+        const auto c = datosDb[k + 1];
+
+        //en una meseta solo cuenta el primer bin
+        if (!(b > a && b >= c))
+            continue;
+
+        //los que ni siquiera entrarian en la lista no merecen recorrer los valles
+        if (resultado.numPicos == numPicos && b <= resultado.picos[(size_t)numPicos - 1].nivelDb)
+            continue;
+
+        if (getProminencia(datosDb, numBins, k) < prominenciaMinimaDb)
+            continue;
+
+        /*
+         parabola por los tres bins en dB. con la ventana Blackman-Harris el lobulo
+         principal en dB es casi una gaussiana, que en escala logaritmica es justo
+         una parabola, asi que esto es la interpolacion gaussiana sobre magnitudes.
+         */
+        auto denominador = a - 2.f * b + c;
+        auto desplazamiento = denominador < 0.f ? 0.5f * (a - c) / denominador : 0.f;
+        desplazamiento = juce::jlimit(-0.5f, 0.5f, desplazamiento);
+
+        PicoEspectral pico;
+        pico.frecuencia = frecuenciaPrimerBin + (float(k) + desplazamiento) * binWidth;
+        pico.nivelDb = b - 0.25f * (a - c) * desplazamiento;
+
+        resultado.aade(pico, numPicos);
+    }
+}
@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    DetectorDePicos.h
+
+    Busqueda de los picos mas altos de una trama en dB del analizador, con
+    interpolacion para tener la frecuencia con precision menor que un bin.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+
+struct PicoEspectral
+{
+    float frecuencia = 0.f;
+    float nivelDb = 0.f;
+};
+
+/**
+ los picos encontrados en una trama, ordenados de mas alto a mas bajo.
+ tamao fijo para poder pasarlo por un Fifo sin reservar memoria.
+ */
+struct PicosEspectrales
+{
+    static constexpr int maxPicos = 8;
+
+    std::array<PicoEspectral, maxPicos> picos;
+    int numPicos = 0;
+
+    //inserta manteniendo el orden, si ya hay 'limite' picos se descarta el mas bajo
+    void aade(const PicoEspectral& pico, int limite);
+};
+
+struct DetectorDePicos
+{
+    void setNumPicos(int nuevoNumPicos) { numPicos = juce::jlimit(0, PicosEspectrales::maxPicos, nuevoNumPicos); }
+    int getNumPicos() const { return numPicos; }
+
+    /**
+     adds the local maxima of 'datosDb' between 'desde' and 'hasta' Hz to 'resultado'.
+     bin k is at frecuenciaPrimerBin + k * binWidth. only peaks that stand at least
+     prominenciaMinimaDb above the higher of the two valleys around them are kept.
+     */
+    void busca(const float* datosDb,
+        int numBins,
+        float binWidth,
+        float frecuenciaPrimerBin,
+        float desde,
+        float hasta,
+        PicosEspectrales& resultado) const;
+
+    static constexpr float prominenciaMinimaDb = 6.f;
+private:
+    float getProminencia(const float* datosDb, int numBins, int bin) const;
+
+    int numPicos = 0;
+};
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    EspectroReasignado.cpp
+
+  ==============================================================================
+*/
+
+#include "EspectroReasignado.h"
+
+void EspectroReasignado::prepare(int ordenFFT)
+{
+    if (motor != nullptr && motor->getOrden() == ordenFFT)
+        return;
+
+    motor = creaMotorFFT(ordenFFT);
+
+    const auto N = motor->getSize();
+    const auto centro = 0.5 * double(N - 1);
+    const auto w = juce::MathConstants<double>::twoPi / double(N - 1);
+
+    //los mismos coeficientes de Blackman-Harris que juce::dsp::WindowingFunction
+    const double a0 = 0.35875, a1 = 0.48829, a2 = 0.14128, a3 = 0.01168;
+
+    ventana.resize((size_t)N);
+    ventanaDerivada.resize((size_t)N);
+    ventanaRampa.resize((size_t)N);
+
+    double sumaCuadrados = 0.0;
+
+    for (int n = 0; n < N; ++n)
+    {
+        const auto x = w * n;
+        const auto h = a0 - a1 * std::cos(x) + a2 * std::cos(2 * x) - a3 * std::cos(3 * x);
+
+        //derivada respecto a n, en unidades por muestra
+        const auto dh = w * (a1 * std::sin(x) - 2 * a2 * std::sin(2 * x) + 3 * a3 * std::sin(3 * x));
+
+        ventana[(size_t)n] = (float)h;
+        ventanaDerivada[(size_t)n] = (float)dh;
+        ventanaRampa[(size_t)n] = (float)((n - centro) * h);
+
+        sumaCuadrados += h * h;
+    }
+
+    /*
+     un seno de amplitud A deja A^2 * sum(h^2) * N / 4 repartido entre los bins de su
+     lobulo, y todos se reasignan a la misma frecuencia: al sumarlos en la columna
+     queda exactamente A^2.
+     */
+    normalizacion = (float)(4.0 / (double(N) * sumaCuadrados));
+
+    for (auto* datos : { &datosVentana, &datosDerivada, &datosRampa })
+        datos->assign((size_t)N * 2, 0.f);
+
+    potencias.assign((size_t)N / 2, 0.f);
+    binesReasignados.assign((size_t)N / 2, -1.f);
+}
+
+void EspectroReasignado::process(const float* muestras)
+{
+    jassert(motor != nullptr);
+
+    const auto N = motor->getSize();
+    const auto numBins = N / 2;
+
+    juce::FloatVectorOperations::multiply(datosVentana.data(), muestras, ventana.data(), N);
+    juce::FloatVectorOperations::multiply(datosDerivada.data(), muestras, ventanaDerivada.data(), N);
+    juce::FloatVectorOperations::multiply(datosRampa.data(), muestras, ventanaRampa.data(), N);
+
+    motor->transformadaReal(datosVentana.data());
+    motor->transformadaReal(datosDerivada.data());
+    motor->transformadaReal(datosRampa.data());
+
+    const auto binesPorRadian = float(N) / juce::MathConstants<float>::twoPi;
+    const auto tiempoMaximo = limiteDeTiempo * float(N);
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const auto hr = datosVentana[2 * (size_t)k], hi = datosVentana[2 * (size_t)k + 1];
+        const auto dr = datosDerivada[2 * (size_t)k], di = datosDerivada[2 * (size_t)k + 1];
+        const auto tr = datosRampa[2 * (size_t)k], ti = datosRampa[2 * (size_t)k + 1];
+
+        const auto potencia = hr * hr + hi * hi;
+
+        if (!(potencia > 0.f) || !std::isfinite(potencia))
+        {
+            potencias[(size_t)k] = 0.f;
+            binesReasignados[(size_t)k] = -1.f;
+            continue;
+        }
+
+        //w^ = w_k - Im(X_dh * conj(X_h)) / |X_h|^2,  t^ = Re(X_th * conj(X_h)) / |X_h|^2
+        const auto correccion = (di * hr - dr * hi) / potencia;
+        const auto tiempo = (tr * hr + ti * hi) / potencia;
+
+        potencias[(size_t)k] = potencia * normalizacion;
+
+        binesReasignados[(size_t)k] = std::abs(tiempo) <= tiempoMaximo
+            ? float(k) - correccion * binesPorRadian
+            : -1.f;
+    }
+}
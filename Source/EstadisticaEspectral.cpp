@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+    EstadisticaEspectral.cpp
+
+  ==============================================================================
+*/
+
+#include "EstadisticaEspectral.h"
+
+int EstadisticaEspectral::getOrdenFFT(double sampleRate)
+{
+    //4096 puntos a 44.1 y 48 kHz, uno mas por cada vez que se dobla
+    return juce::jlimit(11, 14, 12 + juce::roundToInt(std::log2(sampleRate / 48000.0)));
+}
+
+void EstadisticaEspectral::prepare(double sampleRate)
+{
+    const auto orden = getOrdenFFT(sampleRate);
+
+    if (motor != nullptr && motor->getOrden() == orden)
+        return;
+
+    motor = creaMotorFFT(orden);
+
+    const auto N = motor->getSize();
+    const auto numBins = N / 2;
+
+    //la misma ventana que la traza en vivo, para que los percentiles se lean en su escala
+    ventana.resize((size_t)N);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(ventana.data(), (size_t)N,
+        juce::dsp::WindowingFunction<float>::blackmanHarris, true);
+
+    datos.assign((size_t)N * 2, 0.f);
+
+    histogramas.resize((size_t)numBins * numCeldas);
+    suavizado.resize((size_t)numBins);
+    minimoActual.resize((size_t)numBins);
+    minimosAnteriores.resize((size_t)numBins * numSubventanas);
+
+    reinicia();
+}
+
+void EstadisticaEspectral::reinicia()
+{
+    std::fill(histogramas.begin(), histogramas.end(), (uint16_t)0);
+    std::fill(suavizado.begin(), suavizado.end(), 0.f);
+    std::fill(minimoActual.begin(), minimoActual.end(), std::numeric_limits<float>::max());
+    std::fill(minimosAnteriores.begin(), minimosAnteriores.end(), std::numeric_limits<float>::max());
+
+    tramasEnSubventana = 0;
+    subventana = 0;
+    numTramas = 0;
+}
+
+void EstadisticaEspectral::process(const float* muestras)
+{
+    jassert(motor != nullptr);
+
+    const auto N = motor->getSize();
+    const auto numBins = N / 2;
+
+    juce::FloatVectorOperations::multiply(datos.data(), muestras, ventana.data(), N);
+    std::fill(datos.begin() + N, datos.end(), 0.f);
+
+    motor->transformadaSoloPotencia(datos.data());
+
+    //la escala de la traza en vivo: un seno de amplitud 1 en un bin da 0 dB
+    const auto escala = 1.f / (float(numBins) * float(numBins));
+    const auto celdasPorDb = float(numCeldas) / (dbMaximo - dbMinimo);
+    const auto peso = numTramas == 0 ? 1.f : 1.f - alfaSuavizado;
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const auto potencia = datos[(size_t)k] * escala;
+        const auto nivelDb = 10.f * std::log10(juce::jmax(potencia, 1.0e-20f));
+        const auto celda = juce::jlimit(0, numCeldas - 1, (int)std::floor((nivelDb - dbMinimo) * celdasPorDb));
+
+        auto* cuentas = histogramas.data() + (size_t)k * numCeldas;
+
+        //la celda llena: todo el bin a la mitad, los percentiles no se mueven
+        if (++cuentas[celda] == std::numeric_limits<uint16_t>::max())
+            for (int c = 0; c < numCeldas; ++c)
+                cuentas[c] = (uint16_t)(cuentas[c] >> 1);
+
+        suavizado[(size_t)k] += peso * (potencia - suavizado[(size_t)k]);
+        minimoActual[(size_t)k] = juce::jmin(minimoActual[(size_t)k], suavizado[(size_t)k]);
+    }
+
+    ++numTramas;
+
+    //al cerrar un tramo su minimo sustituye al del tramo mas antiguo
+    if (++tramasEnSubventana == tramasPorSubventana)
+    {
+        for (int k = 0; k < numBins; ++k)
+        {
+            minimosAnteriores[(size_t)k * numSubventanas + (size_t)subventana] = minimoActual[(size_t)k];
+            minimoActual[(size_t)k] = std::numeric_limits<float>::max();
+        }
+
+        tramasEnSubventana = 0;
+        subventana = (subventana + 1) % numSubventanas;
+    }
+}
+
+void EstadisticaEspectral::getPercentiles(std::array<std::vector<float>, numPercentiles>& destinos) const
+{
+    const auto numBins = getNumBins();
+    const auto dbPorCelda = (dbMaximo - dbMinimo) / float(numCeldas);
+
+    for (auto& destino : destinos)
+        destino.resize((size_t)numBins);
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const auto* cuentas = histogramas.data() + (size_t)k * numCeldas;
+
+        uint32_t total = 0;
+        for (int c = 0; c < numCeldas; ++c)
+            total += cuentas[c];
+
+        if (total == 0)
+        {
+            for (auto& destino : destinos)
+                destino[(size_t)k] = sinMedida;
+
+            continue;
+        }
+
+        //los percentiles van en orden, una sola pasada por las celdas para los tres
+        auto celda = 0;
+        auto acumulado = 0.f;
+
+        for (int p = 0; p < numPercentiles; ++p)
+        {
+            const auto objetivo = getFraccion(p) * float(total);
+
+            while (celda < numCeldas - 1 && acumulado + float(cuentas[celda]) < objetivo)
+                acumulado += float(cuentas[celda++]);
+
+            //dentro de la celda, como si sus cuentas estuvieran repartidas por igual
+            const auto enLaCelda = juce::jmax(1.f, float(cuentas[celda]));
+            const auto fraccion = juce::jlimit(0.f, 1.f, (objetivo - acumulado) / enLaCelda);
+
+            destinos[(size_t)p][(size_t)k] = dbMinimo + (float(celda) + fraccion) * dbPorCelda;
+        }
+    }
+}
+
+void EstadisticaEspectral::getSueloDeRuido(std::vector<float>& destino) const
+{
+    const auto numBins = getNumBins();
+    destino.resize((size_t)numBins);
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        auto minimo = minimoActual[(size_t)k];
+
+        for (int u = 0; u < numSubventanas; ++u)
+            minimo = juce::jmin(minimo, minimosAnteriores[(size_t)k * numSubventanas + (size_t)u]);
+
+        destino[(size_t)k] = numTramas > 0
+            ? 10.f * std::log10(juce::jmax(sesgoDelMinimo * minimo, 1.0e-20f))
+            : sinMedida;
+    }
+}
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    EstadisticaEspectral.h
+
+    Estadistica por bin de una grabacion larga: los percentiles 10, 50 y 90
+    del nivel, y una estimacion del suelo de ruido por estadistica de
+    minimos.
+
+    Los percentiles salen de un histograma fijo por bin, en celdas de 1 dB
+    entre dbMinimo y dbMaximo, con cuentas de 16 bits. La memoria por bin no
+    crece con la duracion: cuando una celda se llena, todas las del bin se
+    dividen entre dos, lo que no cambia el reparto (y da algo mas de peso a
+    lo reciente). Dentro de cada celda el percentil se interpola.
+
+    El suelo sigue a Martin (2001): el periodograma de cada bin se suaviza
+    con un promedio exponencial y se busca su minimo en unos 2 s, repartidos
+    en numSubventanas tramos para no tener que guardar cada trama. El minimo
+    de un promedio de ruido queda por debajo de su media; sesgoDelMinimo lo
+    corrige para ruido estacionario.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include "MotorFFT.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct EstadisticaEspectral
+{
+    //P10, P50 y P90
+    static constexpr int numPercentiles = 3;
+    static float getFraccion(int percentil) { return percentil == 0 ? 0.1f : (percentil == 1 ? 0.5f : 0.9f); }
+
+    //histograma de cada bin, en dB con la escala de la traza en vivo
+    static constexpr float dbMinimo = -140.f, dbMaximo = 20.f;
+    static constexpr int numCeldas = 160;
+
+    //lo que se devuelve en los bins sin ninguna trama
+    static constexpr float sinMedida = -200.f;
+
+    //suelo de ruido: peso de la trama anterior en el suavizado y ventana del minimo (8 x 6 tramas)
+    static constexpr float alfaSuavizado = 0.8f;
+    static constexpr int numSubventanas = 8, tramasPorSubventana = 6;
+
+    //media / minimo para ruido blanco con esa ventana y ese suavizado, medido
+    static constexpr float sesgoDelMinimo = 1.95f;
+
+    //tramas de unos 85 ms a cualquier frecuencia de muestreo, con solape del 50%
+    static int getOrdenFFT(double sampleRate);
+
+    //reserva todo; si el tamao no cambia no hace nada y se conserva lo acumulado
+    void prepare(double sampleRate);
+    void reinicia();
+
+    int getFFTSize() const { return motor != nullptr ? motor->getSize() : 0; }
+    int getNumBins() const { return getFFTSize() / 2; }
+    int getSalto() const { return getFFTSize() / 2; }
+    int64_t getNumTramas() const { return numTramas; }
+
+    //aade una trama de getFFTSize() muestras
+    void process(const float* muestras);
+
+    //un vector de getNumBins() valores en dB por cada percentil
+    void getPercentiles(std::array<std::vector<float>, numPercentiles>& destinos) const;
+    void getSueloDeRuido(std::vector<float>& destino) const;
+private:
+    std::unique_ptr<MotorFFT> motor;
+    std::vector<float> ventana, datos;
+
+    //numCeldas cuentas por bin, seguidas
+    std::vector<uint16_t> histogramas;
+
+    //por bin: el periodograma suavizado, el minimo del tramo en curso y el de los anteriores
+    std::vector<float> suavizado, minimoActual, minimosAnteriores;
+    int tramasEnSubventana = 0, subventana = 0;
+
+    int64_t numTramas = 0;
+};
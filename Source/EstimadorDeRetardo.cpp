@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    EstimadorDeRetardo.cpp
+
+  ==============================================================================
+*/
+
+#include "EstimadorDeRetardo.h"
+
+void EstimadorDeRetardo::prepare(int ordenVentana)
+{
+    if (fft != nullptr && getTamaoVentana() == (1 << ordenVentana))
+        return;
+
+    fft = std::make_unique<juce::dsp::FFT>(ordenVentana + 1);
+
+    const auto N = getTamaoVentana();
+
+    ventana.resize((size_t)N);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(ventana.data(), (size_t)N,
+        juce::dsp::WindowingFunction<float>::hann, false);
+
+    datosIzq.assign((size_t)fft->getSize() * 2, 0.f);
+    datosDer.assign((size_t)fft->getSize() * 2, 0.f);
+}
+
+float EstimadorDeRetardo::correlacion(int retardo) const
+{
+    //los retardos negativos quedan al final de la correlacion circular
+    const auto M = fft->getSize();
+    return datosIzq[(size_t)((retardo + M) % M)];
+}
+
+double EstimadorDeRetardo::correlacionFraccional(double retardo) const
+{
+    //la transformada inversa en un solo punto, con el giro de cada bin por recurrencia
+    const auto M = fft->getSize();
+    const auto angulo = juce::MathConstants<double>::twoPi * retardo / double(M);
+    const auto paso = std::complex<double>(std::cos(angulo), std::sin(angulo));
+
+    auto giro = paso;
+    auto suma = double(datosDer[0]) + double(datosDer[(size_t)M]) * std::cos(0.5 * angulo * double(M));
+
+    for (int k = 1; k < M / 2; ++k)
+    {
+        suma += 2.0 * (double(datosDer[2 * (size_t)k]) * giro.real() - double(datosDer[2 * (size_t)k + 1]) * giro.imag());
+        giro *= paso;
+    }
+
+    return suma / double(M);
+}
+
+ResultadoDeRetardo EstimadorDeRetardo::process(const float* izquierdo, const float* derecho, double sampleRate)
+{
+    jassert(fft != nullptr);
+
+    ResultadoDeRetardo resultado;
+
+    const auto N = getTamaoVentana();
+    const auto M = fft->getSize();
+
+    juce::FloatVectorOperations::multiply(datosIzq.data(), izquierdo, ventana.data(), N);
+    juce::FloatVectorOperations::multiply(datosDer.data(), derecho, ventana.data(), N);
+    std::fill(datosIzq.begin() + N, datosIzq.end(), 0.f);
+    std::fill(datosDer.begin() + N, datosDer.end(), 0.f);
+
+    //con uno de los dos canales en silencio no hay nada que alinear
+    auto energia = [N](const std::vector<float>& datos)
+    {
+        auto suma = 0.f;
+        for (int n = 0; n < N; ++n)
+            suma += datos[(size_t)n] * datos[(size_t)n];
+        return suma;
+    };
+
+    const auto umbral = float(N) * 1.0e-10f;
+
+    if (energia(datosIzq) < umbral || energia(datosDer) < umbral)
+        return resultado;
+
+    fft->performRealOnlyForwardTransform(datosIzq.data(), true);
+    fft->performRealOnlyForwardTransform(datosDer.data(), true);
+
+    //R L* / |R L*|; se queda en datosDer para refinar el pico y una copia vuelve al tiempo en datosIzq
+    for (int k = 0; k <= M / 2; ++k)
+    {
+        const auto l = juce::dsp::Complex<float>(datosIzq[2 * (size_t)k], datosIzq[2 * (size_t)k + 1]);
+        const auto r = juce::dsp::Complex<float>(datosDer[2 * (size_t)k], datosDer[2 * (size_t)k + 1]);
+        const auto cruzado = r * std::conj(l);
+        const auto modulo = std::abs(cruzado);
+
+        const auto fase = modulo > 1.0e-20f ? cruzado / modulo : juce::dsp::Complex<float>();
+
+        datosDer[2 * (size_t)k] = datosIzq[2 * (size_t)k] = fase.real();
+        datosDer[2 * (size_t)k + 1] = datosIzq[2 * (size_t)k + 1] = fase.imag();
+    }
+
+    fft->performRealOnlyInverseTransform(datosIzq.data());
+
+    const auto maximo = getRetardoMaximo();
+
+    auto pico = -maximo;
+    for (int retardo = -maximo + 1; retardo <= maximo; ++retardo)
+        if (correlacion(retardo) > correlacion(pico))
+            pico = retardo;
+
+    /*
+     the peak only has the shape of a sinc when the whole band is coherent, so neither a
+     parabola nor a sinc fit through the neighbours is unbiased in general. instead the
+     correlation is evaluated between samples straight from the spectrum and the maximum
+     is searched by golden section within one sample of the integer peak.
+     */
+    const auto razonAurea = 0.5 * (std::sqrt(5.0) - 1.0);
+
+    auto a = double(pico) - 1.0, b = double(pico) + 1.0;
+    auto x1 = b - razonAurea * (b - a), x2 = a + razonAurea * (b - a);
+    auto c1 = correlacionFraccional(x1), c2 = correlacionFraccional(x2);
+
+    for (int i = 0; i < iteracionesDelPico; ++i)
+    {
+        if (c1 > c2)
+        {
+            b = x2;
+            x2 = x1;
+            c2 = c1;
+            x1 = b - razonAurea * (b - a);
+            c1 = correlacionFraccional(x1);
+        }
+        else
+        {
+            a = x1;
+            x1 = x2;
+            c1 = c2;
+            x2 = a + razonAurea * (b - a);
+            c2 = correlacionFraccional(x2);
+        }
+    }
+
+    const auto retardo = 0.5 * (a + b);
+
+    resultado.retardoMuestras = (float)retardo;
+    resultado.retardoMs = float(1000.0 * retardo / sampleRate);
+    resultado.confianza = juce::jlimit(0.f, 1.f, (float)correlacionFraccional(retardo));
+    resultado.valido = true;
+
+    return resultado;
+}
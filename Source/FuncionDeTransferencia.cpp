@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    FuncionDeTransferencia.cpp
+
+  ==============================================================================
+*/
+
+#include "FuncionDeTransferencia.h"
+
+void FuncionDeTransferencia::prepare(int ordenFFT)
+{
+    if (fft != nullptr && fft->getSize() == (1 << ordenFFT))
+        return;
+
+    fft = std::make_unique<juce::dsp::FFT>(ordenFFT);
+
+    const auto N = fft->getSize();
+
+    //Hann periodica, con solape del 50% suma constante
+    ventana.resize((size_t)N);
+    for (int n = 0; n < N; ++n)
+        ventana[(size_t)n] = float(0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * n / N));
+
+    tiempo.assign((size_t)N, {});
+    frecuencia.assign((size_t)N, {});
+
+    for (auto* espectro : { &gxx, &gyy, &gxyRe, &gxyIm })
+        espectro->assign((size_t)N / 2, 0.f);
+
+    numPromedios = 0;
+}
+
+void FuncionDeTransferencia::reinicia()
+{
+    for (auto* espectro : { &gxx, &gyy, &gxyRe, &gxyIm })
+        std::fill(espectro->begin(), espectro->end(), 0.f);
+
+    numPromedios = 0;
+}
+
+void FuncionDeTransferencia::process(const float* entrada, const float* salida, float alfa)
+{
+    jassert(fft != nullptr);
+
+    const auto N = fft->getSize();
+    const auto numBins = N / 2;
+
+    //z = x + j y
+    for (int n = 0; n < N; ++n)
+        tiempo[(size_t)n] = { entrada[n] * ventana[(size_t)n], salida[n] * ventana[(size_t)n] };
+
+    fft->perform(tiempo.data(), frecuencia.data(), false);
+
+    //el primer promedio pesa 1, el segundo 1/2... hasta quedarse en alfa
+    ++numPromedios;
+    const auto peso = juce::jmax(alfa, 1.f / float(numPromedios));
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const auto z = frecuencia[(size_t)k];
+        const auto zEspejo = std::conj(frecuencia[(size_t)((N - k) % N)]);
+
+        //X = (Z[k] + conj(Z[N-k])) / 2,  Y = (Z[k] - conj(Z[N-k])) / 2j
+        const auto X = 0.5f * (z + zEspejo);
+        const auto Y = juce::dsp::Complex<float>(0.f, -0.5f) * (z - zEspejo);
+
+        const auto cruzado = std::conj(X) * Y;
+
+        gxx[(size_t)k] += peso * (std::norm(X) - gxx[(size_t)k]);
+        gyy[(size_t)k] += peso * (std::norm(Y) - gyy[(size_t)k]);
+        gxyRe[(size_t)k] += peso * (cruzado.real() - gxyRe[(size_t)k]);
+        gxyIm[(size_t)k] += peso * (cruzado.imag() - gxyIm[(size_t)k]);
+    }
+}
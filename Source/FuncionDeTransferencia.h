@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    FuncionDeTransferencia.h
+
+    Medida en vivo de la funcion de transferencia de la cadena, como un
+    sistema de medida de doble canal: se promedian el autoespectro de la
+    entrada (antes de los filtros), el de la salida y el espectro cruzado
+    entre ambas. De ahi salen H1 = Gxy / Gxx y la coherencia
+    |Gxy|^2 / (Gxx Gyy), que dice cuanto de la salida se explica por la
+    entrada en cada frecuencia.
+
+    Las dos seales son reales, asi que van juntas en una sola FFT compleja
+    (entrada en la parte real, salida en la imaginaria) y se separan por
+    simetria.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <memory>
+#include <vector>
+
+//lo que se dibuja de una medida, un valor por columna de pixeles
+struct MedidaDeTransferencia
+{
+    std::vector<float> magnitudDb, faseGrados, coherencia;
+};
+
+struct FuncionDeTransferencia
+{
+    void prepare(int ordenFFT);
+
+    int getFFTSize() const { return fft != nullptr ? fft->getSize() : 0; }
+    int getNumBins() const { return getFFTSize() / 2; }
+
+    //olvida los promedios, p.ej. despues de un hueco en el audio
+    void reinicia();
+
+    /**
+     adds one frame of getFFTSize() samples of the chain input and output, both starting
+     at the same instant. 'alfa' is the weight of the new frame in the exponential average;
+     the first 1 / alfa frames are averaged linearly so the estimate settles quickly
+     instead of creeping up from zero.
+     */
+    void process(const float* entrada, const float* salida, float alfa);
+
+    int getNumPromedios() const { return numPromedios; }
+
+    //autoespectros y espectro cruzado conj(X) * Y promediados, uno por bin
+    const std::vector<float>& getGxx() const { return gxx; }
+    const std::vector<float>& getGyy() const { return gyy; }
+    const std::vector<float>& getGxyRe() const { return gxyRe; }
+    const std::vector<float>& getGxyIm() const { return gxyIm; }
+private:
+    std::unique_ptr<juce::dsp::FFT> fft;
+
+    std::vector<float> ventana;
+    std::vector<juce::dsp::Complex<float>> tiempo, frecuencia;
+
+    std::vector<float> gxx, gyy, gxyRe, gxyIm;
+    int numPromedios = 0;
+};
@@ -0,0 +1,279 @@
+/*
+  ==============================================================================
+
+    MedidorDeSonoridad.cpp
+
+  ==============================================================================
+*/
+
+#include "MedidorDeSonoridad.h"
+
+void MedidorDeSonoridad::Histograma::vacia()
+{
+    cuenta.fill(0);
+    energia.fill(0.0);
+}
+
+void MedidorDeSonoridad::Histograma::aade(double energiaDelBloque)
+{
+    //la puerta absoluta: lo que queda por debajo de -70 LUFS no entra
+    const auto lufs = aLufs(energiaDelBloque);
+
+    if (lufs < sonoridadMinima)
+        return;
+
+    const auto bin = binDe(lufs);
+    ++cuenta[(size_t)bin];
+    energia[(size_t)bin] += energiaDelBloque;
+}
+
+int MedidorDeSonoridad::Histograma::binDeLaPuerta(float lu) const
+{
+    double suma = 0.0;
+    int total = 0;
+
+    for (int bin = 0; bin < numBinsHistograma; ++bin)
+    {
+        suma += energia[(size_t)bin];
+        total += cuenta[(size_t)bin];
+    }
+
+    if (total == 0)
+        return numBinsHistograma;
+
+    //un bloque justo en la puerta queda fuera, la puerta pide estar por encima
+    const auto puerta = aLufs(suma / double(total)) - lu;
+    return juce::jmax(0, (int)std::floor((puerta - sonoridadMinima) / pasoHistograma) + 1);
+}
+
+int MedidorDeSonoridad::binDe(float lufs)
+{
+    return juce::jlimit(0, numBinsHistograma - 1, (int)std::floor((lufs - sonoridadMinima) / pasoHistograma));
+}
+
+float MedidorDeSonoridad::lufsDelBin(int bin)
+{
+    return sonoridadMinima + (float(bin) + 0.5f) * pasoHistograma;
+}
+
+float MedidorDeSonoridad::aLufs(double energia)
+{
+    return energia > 0.0 ? float(-0.691 + 10.0 * std::log10(energia)) : sinMedida;
+}
+
+void MedidorDeSonoridad::prepare(double sampleRate)
+{
+    frecuencia = sampleRate;
+    muestrasPorSubbloque = juce::jmax(1, juce::roundToInt(0.1 * sampleRate));
+
+    /*
+     the images of a 4x zero stuffing start at fs - 20 kHz, so the passband reaches the
+     audio band and the transition is centred on the original Nyquist.
+     */
+    const auto fir = juce::dsp::FilterDesign<float>::designFIRLowpassKaiserMethod(float(0.5 * sampleRate),
+        sampleRate * factorSobremuestreo,
+        0.04f,
+        -70.f);
+
+    const auto& h = fir->coefficients;
+    longitudFase = int(h.size() + factorSobremuestreo - 1) / factorSobremuestreo;
+
+    //guardadas al reves, para hacer el producto escalar hacia delante
+    fases.assign((size_t)(factorSobremuestreo * longitudFase), 0.f);
+
+    for (int p = 0; p < factorSobremuestreo; ++p)
+        for (int n = 0; n < longitudFase; ++n)
+        {
+            const auto k = n * factorSobremuestreo + p;
+            fases[(size_t)(p * longitudFase + longitudFase - 1 - n)] = k < (int)h.size() ? float(factorSobremuestreo) * h[k] : 0.f;
+        }
+
+    for (auto& linea : lineas)
+        linea.assign((size_t)longitudFase * 2, 0.f);
+
+    reinicia();
+}
+
+void MedidorDeSonoridad::reinicia()
+{
+    muestrasEnSubbloque = 0;
+    energiaDelSubbloque = 0.0;
+    subbloques.fill(0.0);
+    siguienteSubbloque = 0;
+    subbloquesValidos = 0;
+
+    bloquesDePuerta.vacia();
+    bloquesCortoPlazo.vacia();
+
+    for (auto& linea : lineas)
+        std::fill(linea.begin(), linea.end(), 0.f);
+
+    posicion = 0;
+    picoMaximo = 0.f;
+
+    momentaneo.store(sinMedida);
+    cortoPlazo.store(sinMedida);
+    integrado.store(sinMedida);
+    rango.store(0.f);
+    picoVerdadero.store(sinMedida);
+}
+
+void MedidorDeSonoridad::process(const juce::AudioBuffer<float>& ponderado,
+    const juce::AudioBuffer<float>& salida,
+    int inicio,
+    int numMuestras)
+{
+    const auto canales = juce::jmin(numCanales, ponderado.getNumChannels());
+
+    //a trozos que no crucen el final de un subbloque
+    for (int i = 0; i < numMuestras;)
+    {
+        const auto trozo = juce::jmin(numMuestras - i, muestrasPorSubbloque - muestrasEnSubbloque);
+
+        //canales de entrada y salida con peso 1: la suma de las dos potencias
+        for (int canal = 0; canal < canales; ++canal)
+        {
+            const auto* x = ponderado.getReadPointer(canal, i);
+            auto suma = 0.f;
+
+            for (int n = 0; n < trozo; ++n)
+                suma += x[n] * x[n];
+
+            energiaDelSubbloque += suma;
+        }
+
+        i += trozo;
+        muestrasEnSubbloque += trozo;
+
+        if (muestrasEnSubbloque == muestrasPorSubbloque)
+            cierraSubbloque();
+    }
+
+    actualizaPicoVerdadero(salida, inicio, numMuestras);
+}
+
+void MedidorDeSonoridad::cierraSubbloque()
+{
+    subbloques[(size_t)siguienteSubbloque] = energiaDelSubbloque / double(muestrasPorSubbloque);
+    siguienteSubbloque = (siguienteSubbloque + 1) % subbloquesCortoPlazo;
+    subbloquesValidos = juce::jmin(subbloquesCortoPlazo, subbloquesValidos + 1);
+
+    energiaDelSubbloque = 0.0;
+    muestrasEnSubbloque = 0;
+
+    //la media de los ultimos 'numSubbloques', hacia atras desde el que se acaba de cerrar
+    auto media = [this](int numSubbloques)
+    {
+        double suma = 0.0;
+        for (int k = 1; k <= numSubbloques; ++k)
+            suma += subbloques[(size_t)((siguienteSubbloque - k + subbloquesCortoPlazo) % subbloquesCortoPlazo)];
+        return suma / double(numSubbloques);
+    };
+
+    if (subbloquesValidos >= subbloquesMomentaneo)
+    {
+        const auto energia = media(subbloquesMomentaneo);
+        momentaneo.store(aLufs(energia));
+        bloquesDePuerta.aade(energia);
+    }
+
+    if (subbloquesValidos >= subbloquesCortoPlazo)
+    {
+        const auto energia = media(subbloquesCortoPlazo);
+        cortoPlazo.store(aLufs(energia));
+        bloquesCortoPlazo.aade(energia);
+    }
+
+    actualizaIntegradoYRango();
+}
+
+void MedidorDeSonoridad::actualizaIntegradoYRango()
+{
+    //integrada: la media de los bloques por encima de la puerta relativa de -10 LU
+    {
+        double suma = 0.0;
+        int total = 0;
+
+        for (int bin = bloquesDePuerta.binDeLaPuerta(10.f); bin < numBinsHistograma; ++bin)
+        {
+            suma += bloquesDePuerta.energia[(size_t)bin];
+            total += bloquesDePuerta.cuenta[(size_t)bin];
+        }
+
+        integrado.store(total > 0 ? aLufs(suma / double(total)) : sinMedida);
+    }
+
+    //rango (EBU Tech 3342): del percentil 10 al 95 del corto plazo por encima de -20 LU
+    {
+        const auto primerBin = bloquesCortoPlazo.binDeLaPuerta(20.f);
+
+        int total = 0;
+        for (int bin = primerBin; bin < numBinsHistograma; ++bin)
+            total += bloquesCortoPlazo.cuenta[(size_t)bin];
+
+        if (total == 0)
+        {
+            rango.store(0.f);
+            return;
+        }
+
+        auto percentil = [&](double fraccion)
+        {
+            const auto objetivo = fraccion * double(total);
+            int acumulado = 0;
+
+            for (int bin = primerBin; bin < numBinsHistograma; ++bin)
+            {
+                acumulado += bloquesCortoPlazo.cuenta[(size_t)bin];
+
+                if (double(acumulado) > objetivo)
+                    return lufsDelBin(bin);
+            }
+
+            return lufsDelBin(numBinsHistograma - 1);
+        };
+
+        rango.store(percentil(0.95) - percentil(0.10));
+    }
+}
+
+void MedidorDeSonoridad::actualizaPicoVerdadero(const juce::AudioBuffer<float>& salida, int inicio, int numMuestras)
+{
+    const auto canales = juce::jmin(numCanales, salida.getNumChannels());
+    auto pico = picoMaximo;
+    auto nuevaPosicion = posicion;
+
+    for (int canal = 0; canal < canales; ++canal)
+    {
+        const auto* x = salida.getReadPointer(canal, inicio);
+        auto* linea = lineas[(size_t)canal].data();
+        auto pos = posicion;
+
+        for (int i = 0; i < numMuestras; ++i)
+        {
+            //la linea va duplicada, asi las ultimas longitudFase muestras siempre estan seguidas
+            linea[pos] = linea[pos + longitudFase] = x[i];
+            pos = (pos + 1) % longitudFase;
+
+            const auto* ventana = linea + pos;
+
+            for (int p = 0; p < factorSobremuestreo; ++p)
+            {
+                const auto* h = fases.data() + p * longitudFase;
+                auto y = 0.f;
+
+                for (int n = 0; n < longitudFase; ++n)
+                    y += h[n] * ventana[n];
+
+                pico = juce::jmax(pico, std::abs(y));
+            }
+        }
+
+        nuevaPosicion = pos;
+    }
+
+    posicion = nuevaPosicion;
+    picoMaximo = pico;
+
+    picoVerdadero.store(pico > 0.f ? juce::Decibels::gainToDecibels(pico, sinMedida) : sinMedida);
+}
@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    MedidorDeSonoridad.h
+
+    Sonoridad segun ITU-R BS.1770 y EBU R128 de la salida, en el hilo de
+    audio y sin reservar memoria despues de prepare().
+
+    La energia de la seal ya ponderada en K (el procesador la filtra con
+    la misma cadena de dsp que el ecualizador) se acumula en subbloques de
+    100 ms. Cuatro subbloques son la sonoridad momentanea y cada bloque de
+    puerta de 400 ms con un 75% de solape; treinta son la de corto plazo.
+    Los bloques van a histogramas de 0.1 LU con su energia, asi la integrada
+    (puertas de -70 LUFS y -10 LU) y el rango de sonoridad (puertas de
+    -70 LUFS y -20 LU, percentiles 10 y 95) salen de recorrerlos, sin
+    guardar la historia entera.
+
+    El pico verdadero se mide sobre la salida sin ponderar, interpolada 4x
+    con un FIR polifasico.
+
+    Los resultados se publican en atomicos, el editor los lee cuando quiere.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+struct MedidorDeSonoridad
+{
+    static constexpr int numCanales = 2;
+
+    //lo que se publica mientras no hay medida
+    static constexpr float sinMedida = -200.f;
+
+    //fuera del hilo de audio (prepareToPlay), disea el interpolador y reserva sus lineas
+    void prepare(double sampleRate);
+
+    //hilo de audio: empieza una medida nueva
+    void reinicia();
+
+    /*
+     audio thread. 'ponderado' holds the K-weighted output from sample 0, 'salida' the same
+     output unweighted from sample 'inicio'; both carry 'numMuestras' samples.
+     */
+    void process(const juce::AudioBuffer<float>& ponderado,
+        const juce::AudioBuffer<float>& salida,
+        int inicio,
+        int numMuestras);
+
+    //cualquier hilo; LUFS, LU y dBTP
+    float getMomentaneo() const { return momentaneo.load(); }
+    float getCortoPlazo() const { return cortoPlazo.load(); }
+    float getIntegrado() const { return integrado.load(); }
+    float getRango() const { return rango.load(); }
+    float getPicoVerdadero() const { return picoVerdadero.load(); }
+private:
+    void cierraSubbloque();
+    void actualizaIntegradoYRango();
+    void actualizaPicoVerdadero(const juce::AudioBuffer<float>& salida, int inicio, int numMuestras);
+
+    static float aLufs(double energia);
+
+    static constexpr int subbloquesMomentaneo = 4, subbloquesCortoPlazo = 30;
+
+    //histogramas de -70 a +5 LUFS en pasos de 0.1 LU
+    static constexpr float sonoridadMinima = -70.f, pasoHistograma = 0.1f;
+    static constexpr int numBinsHistograma = 751;
+
+    struct Histograma
+    {
+        std::array<int, numBinsHistograma> cuenta{};
+        std::array<double, numBinsHistograma> energia{};
+
+        void vacia();
+        void aade(double energiaDelBloque);
+
+        //el primer bin por encima de una puerta relativa de 'lu' bajo la media de todo lo que hay
+        int binDeLaPuerta(float lu) const;
+    };
+
+    static int binDe(float lufs);
+    static float lufsDelBin(int bin);
+
+    double frecuencia = 48000.0;
+    int muestrasPorSubbloque = 4800, muestrasEnSubbloque = 0;
+    double energiaDelSubbloque = 0.0;
+
+    //las energias medias de los ultimos subbloques, en anillo
+    std::array<double, subbloquesCortoPlazo> subbloques{};
+    int siguienteSubbloque = 0, subbloquesValidos = 0;
+
+    Histograma bloquesDePuerta, bloquesCortoPlazo;
+
+    //interpolador 4x: fase p, coeficiente n = h[4n + p], ya multiplicado por 4
+    static constexpr int factorSobremuestreo = 4;
+    std::vector<float> fases;
+    int longitudFase = 1;
+    std::array<std::vector<float>, numCanales> lineas;
+    int posicion = 0;
+    float picoMaximo = 0.f;
+
+    std::atomic<float> momentaneo{ sinMedida }, cortoPlazo{ sinMedida }, integrado{ sinMedida };
+    std::atomic<float> rango{ 0.f }, picoVerdadero{ sinMedida };
+};
@@ -0,0 +1,307 @@
+/*
+  ==============================================================================
+
+    MotorFFT.cpp
+
+  ==============================================================================
+*/
+
+#include "MotorFFT.h"
+
+MotorFFTInterno::MotorFFTInterno(int ordenFFT) :
+    MotorFFT(ordenFFT),
+    tamaoComplejo(1 << (ordenFFT - 1))
+{
+    jassert(ordenFFT >= 2);
+
+    const auto numVecs = (tamaoComplejo + (int)Vec::SIMDNumElements - 1) / (int)Vec::SIMDNumElements;
+    for (auto& a : almacen)
+        a.resize((size_t)numVecs);
+
+    const auto dosPi = juce::MathConstants<double>::twoPi;
+
+    //etapas radix-4 mientras quepan, la ultima radix-2 si log2(N/2) es impar
+    for (int n = tamaoComplejo, s = 1; n > 1; )
+    {
+        Etapa etapa;
+        etapa.longitud = n;
+        etapa.paso = s;
+        etapa.offsetGiros = (int)girosRe.size();
+        etapas.push_back(etapa);
+
+        if (n == 2)
+            break;
+
+        const auto cuarto = n / 4;
+        const auto theta = dosPi / double(n);
+
+        for (int k = 1; k <= 3; ++k)
+        {
+            for (int p = 0; p < cuarto; ++p)
+            {
+                girosRe.push_back((float)std::cos(theta * k * p));
+                girosIm.push_back((float)-std::sin(theta * k * p));
+            }
+        }
+
+        n /= 4;
+        s *= 4;
+    }
+
+    const auto N = getSize();
+    for (int k = 0; k <= tamaoComplejo; ++k)
+    {
+        girosRealRe.push_back((float)std::cos(dosPi * k / double(N)));
+        girosRealIm.push_back((float)-std::sin(dosPi * k / double(N)));
+    }
+}
+
+void MotorFFTInterno::transformadaCompleja()
+{
+    int origen = 0;
+    const auto anchoVec = (int)Vec::SIMDNumElements;
+
+    for (const auto& etapa : etapas)
+    {
+        const auto destino = 1 - origen;
+        const auto* xr = re(origen);
+        const auto* xi = im(origen);
+        auto* yr = re(destino);
+        auto* yi = im(destino);
+
+        const auto n = etapa.longitud;
+        const auto s = etapa.paso;
+
+        if (n == 2)
+        {
+            for (int q = 0; q < s; ++q)
+            {
+                auto ar = xr[q], ai = xi[q];
+                auto br = xr[q + s], bi = xi[q + s];
+                yr[q] = ar + br;          yi[q] = ai + bi;
+                yr[q + s] = ar - br;      yi[q + s] = ai - bi;
+            }
+
+            origen = destino;
+            continue;
+        }
+
+        const auto cuarto = n / 4;
+        const auto* w1r = girosRe.data() + etapa.offsetGiros;
+        const auto* w1i = girosIm.data() + etapa.offsetGiros;
+        const auto* w2r = w1r + cuarto;
+        const auto* w2i = w1i + cuarto;
+        const auto* w3r = w2r + cuarto;
+        const auto* w3i = w2i + cuarto;
+
+        const auto usaSIMD = (s % anchoVec) == 0;
+
+        for (int p = 0; p < cuarto; ++p)
+        {
+            const auto i0 = s * p;
+            const auto i1 = s * (p + cuarto);
+            const auto i2 = s * (p + 2 * cuarto);
+            const auto i3 = s * (p + 3 * cuarto);
+            const auto o0 = s * (4 * p);
+            const auto o1 = o0 + s;
+            const auto o2 = o1 + s;
+            const auto o3 = o2 + s;
+
+            int q = 0;
+
+            if (usaSIMD)
+            {
+                const auto vw1r = Vec::expand(w1r[p]), vw1i = Vec::expand(w1i[p]);
+                const auto vw2r = Vec::expand(w2r[p]), vw2i = Vec::expand(w2i[p]);
+                const auto vw3r = Vec::expand(w3r[p]), vw3i = Vec::expand(w3i[p]);
+
+                for (; q < s; q += anchoVec)
+                {
+                    auto ar = Vec::fromRawArray(xr + i0 + q), ai = Vec::fromRawArray(xi + i0 + q);
+                    auto br = Vec::fromRawArray(xr + i1 + q), bi = Vec::fromRawArray(xi + i1 + q);
+                    auto cr = Vec::fromRawArray(xr + i2 + q), ci = Vec::fromRawArray(xi + i2 + q);
+                    auto dr = Vec::fromRawArray(xr + i3 + q), di = Vec::fromRawArray(xi + i3 + q);
+
+                    auto apcR = ar + cr, apcI = ai + ci;
+                    auto amcR = ar - cr, amcI = ai - ci;
+                    auto bpdR = br + dr, bpdI = bi + di;
+                    //j * (b - d)
+                    auto jbmdR = di - bi, jbmdI = br - dr;
+
+                    (apcR + bpdR).copyToRawArray(yr + o0 + q);
+                    (apcI + bpdI).copyToRawArray(yi + o0 + q);
+
+                    auto t1r = amcR - jbmdR, t1i = amcI - jbmdI;
+                    (t1r * vw1r - t1i * vw1i).copyToRawArray(yr + o1 + q);
+                    (t1r * vw1i + t1i * vw1r).copyToRawArray(yi + o1 + q);
+
+                    auto t2r = apcR - bpdR, t2i = apcI - bpdI;
+                    (t2r * vw2r - t2i * vw2i).copyToRawArray(yr + o2 + q);
+                    (t2r * vw2i + t2i * vw2r).copyToRawArray(yi + o2 + q);
+
+                    auto t3r = amcR + jbmdR, t3i = amcI + jbmdI;
+                    (t3r * vw3r - t3i * vw3i).copyToRawArray(yr + o3 + q);
+                    (t3r * vw3i + t3i * vw3r).copyToRawArray(yi + o3 + q);
+                }
+            }
+
+            for (; q < s; ++q)
+            {
+                auto ar = xr[i0 + q], ai = xi[i0 + q];
+                auto br = xr[i1 + q], bi = xi[i1 + q];
+                auto cr = xr[i2 + q], ci = xi[i2 + q];
+                auto dr = xr[i3 + q], di = xi[i3 + q];
+
+                auto apcR = ar + cr, apcI = ai + ci;
+                auto amcR = ar - cr, amcI = ai - ci;
+                auto bpdR = br + dr, bpdI = bi + di;
+                auto jbmdR = di - bi, jbmdI = br - dr;
+
+                yr[o0 + q] = apcR + bpdR;
+                yi[o0 + q] = apcI + bpdI;
+
+                auto t1r = amcR - jbmdR, t1i = amcI - jbmdI;
+                yr[o1 + q] = t1r * w1r[p] - t1i * w1i[p];
+                yi[o1 + q] = t1r * w1i[p] + t1i * w1r[p];
+
+                auto t2r = apcR - bpdR, t2i = apcI - bpdI;
+                yr[o2 + q] = t2r * w2r[p] - t2i * w2i[p];
+                yi[o2 + q] = t2r * w2i[p] + t2i * w2r[p];
+
+                auto t3r = amcR + jbmdR, t3i = amcI + jbmdI;
+                yr[o3 + q] = t3r * w3r[p] - t3i * w3i[p];
+                yi[o3 + q] = t3r * w3i[p] + t3i * w3r[p];
+            }
+        }
+
+        origen = destino;
+    }
+
+    bufferResultado = origen;
+}
+
+void MotorFFTInterno::transformadaReal(float* datos)
+{
+    const auto M = tamaoComplejo;
+
+    //z[n] = x[2n] + i x[2n+1]
+    auto* zr = re(0);
+    auto* zi = im(0);
+    for (int n = 0; n < M; ++n)
+    {
+        zr[n] = datos[2 * n];
+        zi[n] = datos[2 * n + 1];
+    }
+
+    transformadaCompleja();
+
+    zr = re(bufferResultado);
+    zi = im(bufferResultado);
+
+    //X[k] = (Z[k] + Z*[M-k]) / 2 - i e^(-2 pi i k / N) (Z[k] - Z*[M-k]) / 2
+    datos[0] = zr[0] + zi[0];
+    datos[1] = 0.f;
+    datos[2 * M] = zr[0] - zi[0];
+    datos[2 * M + 1] = 0.f;
+
+    for (int k = 1; k < M; ++k)
+    {
+        auto ar = zr[k], ai = zi[k];
+        auto br = zr[M - k], bi = -zi[M - k];
+
+        auto parR = 0.5f * (ar + br), parI = 0.5f * (ai + bi);
+        //-i * (a - b) / 2
+        auto imparR = 0.5f * (ai - bi), imparI = -0.5f * (ar - br);
+
+        auto wr = girosRealRe[k], wi = girosRealIm[k];
+        datos[2 * k] = parR + imparR * wr - imparI * wi;
+        datos[2 * k + 1] = parI + imparR * wi + imparI * wr;
+    }
+}
+
+//==============================================================================
+std::unique_ptr<MotorFFT> creaMotorFFT(int ordenFFT, TipoMotorFFT tipo)
+{
+    if (tipo == TipoMotorFFT::Interno)
+        return std::make_unique<MotorFFTInterno>(ordenFFT);
+
+    return std::make_unique<MotorFFTJuce>(ordenFFT);
+}
+
+static double midePorTransformada(MotorFFT& motor)
+{
+    std::vector<float> datos((size_t)motor.getSize() * 2);
+    juce::Random r(1234);
+
+    auto rellena = [&datos, &r]()
+    {
+        for (auto& v : datos)
+            v = r.nextFloat() * 2.f - 1.f;
+    };
+
+    //unas cuantas pasadas de calentamiento para las caches
+    for (int i = 0; i < 2; ++i)
+    {
+        rellena();
+        motor.transformadaReal(datos.data());
+    }
+
+    const auto repeticiones = juce::jmax(4, (1 << 18) / motor.getSize());
+    auto mejor = std::numeric_limits<double>::max();
+
+    for (int intento = 0; intento < 3; ++intento)
+    {
+        rellena();
+        auto inicio = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < repeticiones; ++i)
+            motor.transformadaReal(datos.data());
+
+        auto segundos = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - inicio);
+        mejor = juce::jmin(mejor, segundos / repeticiones);
+    }
+
+    return mejor;
+}
+
+std::unique_ptr<MotorFFT> creaMotorFFT(int ordenFFT)
+{
+    static juce::CriticalSection lock;
+    static std::array<int, 32> elegidos{};   //0 sin medir, 1 + TipoMotorFFT si no
+
+    jassert(ordenFFT > 1 && ordenFFT < 32);
+
+    const juce::ScopedLock sl(lock);
+
+    if (elegidos[(size_t)ordenFFT] == 0)
+    {
+        auto forzado = juce::SystemStats::getEnvironmentVariable("MONITOR_ESPECTRO_FFT", {}).trim().toLowerCase();
+        TipoMotorFFT tipo;
+
+        if (forzado == "juce" || forzado == "interno")
+        {
+            tipo = forzado == "juce" ? TipoMotorFFT::Juce : TipoMotorFFT::Interno;
+            juce::Logger::writeToLog("MotorFFT orden " + juce::String(ordenFFT) + ": " + forzado
+                + " (forzado por MONITOR_ESPECTRO_FFT)");
+        }
+        else
+        {
+            MotorFFTJuce motorJuce(ordenFFT);
+            MotorFFTInterno motorInterno(ordenFFT);
+
+            auto tiempoJuce = midePorTransformada(motorJuce);
+            auto tiempoInterno = midePorTransformada(motorInterno);
+
+            tipo = tiempoInterno < tiempoJuce ? TipoMotorFFT::Interno : TipoMotorFFT::Juce;
+
+            juce::Logger::writeToLog("MotorFFT orden " + juce::String(ordenFFT)
+                + ": juce " + juce::String(tiempoJuce * 1.0e6, 1) + " us"
+                + ", interno " + juce::String(tiempoInterno * 1.0e6, 1) + " us"
+                + " -> " + (tipo == TipoMotorFFT::Interno ? "interno" : "juce"));
+        }
+
+        elegidos[(size_t)ordenFFT] = 1 + (int)tipo;
+    }
+
+    return creaMotorFFT(ordenFFT, (TipoMotorFFT)(elegidos[(size_t)ordenFFT] - 1));
+}
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    MotorFFT.h
+
+    Interfaz comun para los motores de FFT real que usa el analizador.
+    creaMotorFFT() elige, para cada tamao, el motor mas rapido en esta maquina
+    con una pequea medicion la primera vez que se pide ese tamao.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+struct MotorFFT
+{
+    explicit MotorFFT(int ordenFFT) : orden(ordenFFT) { }
+    virtual ~MotorFFT() = default;
+
+    int getOrden() const { return orden; }
+    int getSize() const { return 1 << orden; }
+
+    virtual juce::String getNombre() const = 0;
+
+    /**
+     same contract as juce::dsp::FFT::performRealOnlyForwardTransform(datos, true):
+     takes getSize() real samples and leaves getSize() / 2 + 1 interleaved complex
+     bins in place. 'datos' must hold 2 * getSize() floats.
+     */
+    virtual void transformadaReal(float* datos) = 0;
+
+    //same contract as juce::dsp::FFT::performFrequencyOnlyForwardTransform
+    void transformadaSoloMagnitud(float* datos)
+    {
+        transformadaReal(datos);
+
+        const auto numBins = getSize() / 2 + 1;
+        for (int k = 0; k < numBins; ++k)
+            datos[k] = std::hypot(datos[2 * k], datos[2 * k + 1]);
+    }
+
+    //like transformadaSoloMagnitud but leaves re^2 + im^2, non-finite bins come out as 0
+    void transformadaSoloPotencia(float* datos)
+    {
+        transformadaReal(datos);
+
+        const auto numBins = getSize() / 2 + 1;
+        for (int k = 0; k < numBins; ++k)
+        {
+            auto potencia = datos[2 * k] * datos[2 * k] + datos[2 * k + 1] * datos[2 * k + 1];
+            datos[k] = std::isfinite(potencia) ? potencia : 0.f;
+        }
+    }
+private:
+    const int orden;
+};
+
+struct MotorFFTJuce : MotorFFT
+{
+    explicit MotorFFTJuce(int ordenFFT) : MotorFFT(ordenFFT), fft(ordenFFT) { }
+
+    juce::String getNombre() const override { return "juce"; }
+
+    void transformadaReal(float* datos) override
+    {
+        fft.performRealOnlyForwardTransform(datos, true);
+    }
+private:
+    juce::dsp::FFT fft;
+};
+
+/**
+ radix-4 Stockham FFT (natural order, no bit reversal) over split re/im arrays.
+ a real transform of size N is done as a complex one of size N/2 plus a twiddle
+ pass. the butterflies run on juce::dsp::SIMDRegister across the contiguous
+ inner index, the first stage (stride 1) and the final radix-2 stage when
+ log2(N/2) is odd run scalar.
+ */
+struct MotorFFTInterno : MotorFFT
+{
+    explicit MotorFFTInterno(int ordenFFT);
+
+    juce::String getNombre() const override { return "interno"; }
+
+    void transformadaReal(float* datos) override;
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    struct Etapa
+    {
+        int longitud = 0;   //n de la subtransformada
+        int paso = 0;       //s, distancia entre elementos de la misma subtransformada
+        int offsetGiros = 0;
+    };
+
+    void transformadaCompleja();
+
+    float* re(int buffer) { return reinterpret_cast<float*>(almacen[buffer * 2].data()); }
+    float* im(int buffer) { return reinterpret_cast<float*>(almacen[buffer * 2 + 1].data()); }
+
+    const int tamaoComplejo;
+
+    //dos buffers (re, im) para ir alternando entre etapas
+    std::array<std::vector<Vec>, 4> almacen;
+    int bufferResultado = 0;
+
+    std::vector<Etapa> etapas;
+    std::vector<float> girosRe, girosIm;          //w^p, w^2p, w^3p de cada etapa
+    std::vector<float> girosRealRe, girosRealIm;  //e^(-2 pi i k / N) para separar la parte real
+};
+
+enum class TipoMotorFFT
+{
+    Juce,
+    Interno
+};
+
+/**
+ returns the fastest engine for the given order on this machine.
+ the choice can be forced with the environment variable
+ MONITOR_ESPECTRO_FFT=juce|interno and is written to the juce::Logger.
+ */
+std::unique_ptr<MotorFFT> creaMotorFFT(int ordenFFT);
+
+std::unique_ptr<MotorFFT> creaMotorFFT(int ordenFFT, TipoMotorFFT tipo);
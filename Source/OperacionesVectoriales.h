@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+
+    OperacionesVectoriales.h
+
+    Bucles vectorizados (SSE2 / NEON, con version escalar de respaldo) para las
+    pasadas por bin del analizador.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <cstring>
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#elif JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
+namespace OperacionesVectoriales
+{
+    /*
+     log2(1 + t) ~= t * (c1 + t * (c2 + t * (c3 + t * (c4 + t * c5)))) para t en [0, 1).
+     aproximacion minimax: error maximo 1.5e-5 en log2, es decir 9e-5 dB. sumando el
+     redondeo en float el error frente a juce::Decibels::gainToDecibels queda por
+     debajo de 2e-4 dB en todo el rango, muy por debajo de un pixel del analizador.
+     */
+    constexpr float c1 = 1.44196563f;
+    constexpr float c2 = -0.70966296f;
+    constexpr float c3 = 0.41759630f;
+    constexpr float c4 = -0.19627036f;
+    constexpr float c5 = 0.04638570f;
+
+    //20 * log10(2), pasa de log2 a dB de amplitud
+    constexpr float decibeliosPorOctava = 6.02059991f;
+
+    //10 * log10(2), lo mismo para dB de potencia
+    constexpr float decibeliosPorOctavaPotencia = 3.01029996f;
+
+    //cualquier valor por debajo se trata como silencio, evita denormales y log(0)
+    constexpr float gananciaMinima = 1.0e-30f;
+
+    inline float log2Rapido(float x)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        auto exponente = float(int32_t(bits >> 23) - 127);
+
+        bits = (bits & 0x007fffffu) | 0x3f800000u;
+        float mantisa;
+        std::memcpy(&mantisa, &bits, sizeof(mantisa));
+
+        auto t = mantisa - 1.f;
+        return exponente + t * (c1 + t * (c2 + t * (c3 + t * (c4 + t * c5))));
+    }
+
+    /**
+     sanea, normaliza y pasa a dB en una sola pasada:
+     datos[i] = dbPorOctava * log2(isfinite(datos[i]) ? datos[i] * escala : 0), nunca por debajo de negativeInfinity
+     */
+    inline void aDecibelios(float* datos, int numValores, float escala, float negativeInfinity, float dbPorOctava)
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const auto vEscala = _mm_set1_ps(escala);
+        const auto vMinimo = _mm_set1_ps(gananciaMinima);
+        const auto vSuelo = _mm_set1_ps(negativeInfinity);
+        const auto vUno = _mm_set1_ps(1.f);
+        const auto vDbPorOctava = _mm_set1_ps(dbPorOctava);
+        const auto vMascaraMantisa = _mm_set1_epi32(0x007fffff);
+        const auto vExponenteCero = _mm_set1_epi32(0x3f800000);
+        const auto vSesgo = _mm_set1_epi32(127);
+
+        for (; i + 4 <= numValores; i += 4)
+        {
+            auto v = _mm_loadu_ps(datos + i);
+
+            //x - x es 0 solo si x es finito, NaN para inf y NaN
+            auto finito = _mm_cmpeq_ps(_mm_sub_ps(v, v), _mm_setzero_ps());
+            v = _mm_and_ps(v, finito);
+            v = _mm_max_ps(_mm_mul_ps(v, vEscala), vMinimo);
+
+            auto bits = _mm_castps_si128(v);
+            auto exponente = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), vSesgo));
+            auto mantisa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, vMascaraMantisa), vExponenteCero));
+            auto t = _mm_sub_ps(mantisa, vUno);
+
+            auto p = _mm_add_ps(_mm_set1_ps(c4), _mm_mul_ps(t, _mm_set1_ps(c5)));
+            p = _mm_add_ps(_mm_set1_ps(c3), _mm_mul_ps(t, p));
+            p = _mm_add_ps(_mm_set1_ps(c2), _mm_mul_ps(t, p));
+            p = _mm_add_ps(_mm_set1_ps(c1), _mm_mul_ps(t, p));
+
+            auto db = _mm_mul_ps(_mm_add_ps(exponente, _mm_mul_ps(t, p)), vDbPorOctava);
+            _mm_storeu_ps(datos + i, _mm_max_ps(db, vSuelo));
+        }
+       #elif JUCE_USE_ARM_NEON
+        const auto vMinimo = vdupq_n_f32(gananciaMinima);
+        const auto vSuelo = vdupq_n_f32(negativeInfinity);
+        const auto vUno = vdupq_n_f32(1.f);
+        const auto vMascaraMantisa = vdupq_n_u32(0x007fffffu);
+        const auto vExponenteCero = vdupq_n_u32(0x3f800000u);
+        const auto vSesgo = vdupq_n_s32(127);
+
+        for (; i + 4 <= numValores; i += 4)
+        {
+            auto v = vld1q_f32(datos + i);
+
+            auto finito = vceqq_f32(vsubq_f32(v, v), vdupq_n_f32(0.f));
+            v = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), finito));
+            v = vmaxq_f32(vmulq_n_f32(v, escala), vMinimo);
+
+            auto bits = vreinterpretq_u32_f32(v);
+            auto exponente = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vSesgo));
+            auto mantisa = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vMascaraMantisa), vExponenteCero));
+            auto t = vsubq_f32(mantisa, vUno);
+
+            auto p = vmlaq_n_f32(vdupq_n_f32(c4), t, c5);
+            p = vmlaq_f32(vdupq_n_f32(c3), t, p);
+            p = vmlaq_f32(vdupq_n_f32(c2), t, p);
+            p = vmlaq_f32(vdupq_n_f32(c1), t, p);
+
+            auto db = vmulq_n_f32(vmlaq_f32(exponente, t, p), dbPorOctava);
+            vst1q_f32(datos + i, vmaxq_f32(db, vSuelo));
+        }
+       #endif
+
+        for (; i < numValores; ++i)
+        {
+            auto v = datos[i];
+            v = std::isfinite(v) ? v * escala : 0.f;
+            v = juce::jmax(v, gananciaMinima);
+            datos[i] = juce::jmax(dbPorOctava * log2Rapido(v), negativeInfinity);
+        }
+    }
+
+    //datos[i] = gainToDecibels(isfinite(datos[i]) ? datos[i] * escala : 0, negativeInfinity)
+    inline void magnitudesADecibelios(float* datos, int numValores, float escala, float negativeInfinity)
+    {
+        aDecibelios(datos, numValores, escala, negativeInfinity, decibeliosPorOctava);
+    }
+
+    //lo mismo para potencias: 10 * log10(datos[i] * escala)
+    inline void potenciasADecibelios(float* datos, int numValores, float escala, float negativeInfinity)
+    {
+        aDecibelios(datos, numValores, escala, negativeInfinity, decibeliosPorOctavaPotencia);
+    }
+
+    /**
+     filtro de un polo por bin con coeficiente distinto para subir y para bajar:
+     estado[i] += (datos[i] > estado[i] ? coefSubida : coefBajada) * (datos[i] - estado[i]),
+     y el resultado se copia tambien en datos. con los dos coeficientes iguales es un
+     promedio exponencial. los datos tienen que venir ya saneados.
+     */
+    inline void seguimientoBalistico(float* estado, float* datos, int numValores, float coefSubida, float coefBajada)
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const auto vSubida = _mm_set1_ps(coefSubida);
+        const auto vBajada = _mm_set1_ps(coefBajada);
+
+        for (; i + 4 <= numValores; i += 4)
+        {
+            auto e = _mm_loadu_ps(estado + i);
+            auto diferencia = _mm_sub_ps(_mm_loadu_ps(datos + i), e);
+
+            auto sube = _mm_cmpgt_ps(diferencia, _mm_setzero_ps());
+            auto coef = _mm_or_ps(_mm_and_ps(sube, vSubida), _mm_andnot_ps(sube, vBajada));
+
+            e = _mm_add_ps(e, _mm_mul_ps(coef, diferencia));
+            _mm_storeu_ps(estado + i, e);
+            _mm_storeu_ps(datos + i, e);
+        }
+       #elif JUCE_USE_ARM_NEON
+        const auto vSubida = vdupq_n_f32(coefSubida);
+        const auto vBajada = vdupq_n_f32(coefBajada);
+
+        for (; i + 4 <= numValores; i += 4)
+        {
+            auto e = vld1q_f32(estado + i);
+            auto diferencia = vsubq_f32(vld1q_f32(datos + i), e);
+
+            auto coef = vbslq_f32(vcgtq_f32(diferencia, vdupq_n_f32(0.f)), vSubida, vBajada);
+
+            e = vmlaq_f32(e, coef, diferencia);
+            vst1q_f32(estado + i, e);
+            vst1q_f32(datos + i, e);
+        }
+       #endif
+
+        for (; i < numValores; ++i)
+        {
+            auto diferencia = datos[i] - estado[i];
+            estado[i] += (diferencia > 0.f ? coefSubida : coefBajada) * diferencia;
+            datos[i] = estado[i];
+        }
+    }
+}
@@ -224,8 +224,14 @@ juce::String SliderRotatorioConEtiquetas::getDisplayString() const
 //==============================================================================
 ComponenteAnalizador::ComponenteAnalizador(MonitorDeEspectroDeSealAudioProcessor& p) :
     audioProcessor(p),
-    productorOndaIzq(audioProcessor.canalIzqFIFO),
-    productorOndaDer(audioProcessor.canalDerFIFO)
+    productorOndaIzq(audioProcessor.canalIzqFIFO, audioProcessor.canalIzqPreFIFO, audioProcessor.canalIzqReferenciaFIFO),
+    productorOndaDer(audioProcessor.canalDerFIFO, audioProcessor.canalDerPreFIFO, audioProcessor.canalDerReferenciaFIFO),
+    reanalisisCongelado(audioProcessor.capturaRetroactiva),
+    medidaConBarrido(audioProcessor.barridoSinusoidal),
+    analisisDeDistorsion(audioProcessor.canalDistorsionFIFO),
+    analisisEstereo(audioProcessor.canalIzqEstereoFIFO, audioProcessor.canalDerEstereoFIFO),
+    analisisDeRetardo(audioProcessor.canalIzqRetardoFIFO, audioProcessor.canalDerRetardoFIFO),
+    analisisEstadistico(audioProcessor.canalIzqEstadisticaFIFO, audioProcessor.canalDerEstadisticaFIFO)
 {
     const auto& params = audioProcessor.getParameters();
     for (auto param : params)
@@ -235,11 +241,40 @@ ComponenteAnalizador::ComponenteAnalizador(MonitorDeEspectroDeSe
 
     updateChain();
 
+    audioProcessor.poolDeAnalisis->registra(productorOndaIzq);
+    audioProcessor.poolDeAnalisis->registra(productorOndaDer);
+    audioProcessor.poolDeAnalisis->registra(reanalisisCongelado);
+    audioProcessor.poolDeAnalisis->registra(medidaConBarrido);
+    audioProcessor.poolDeAnalisis->registra(analisisDeDistorsion);
+    audioProcessor.poolDeAnalisis->registra(analisisEstereo);
+    audioProcessor.poolDeAnalisis->registra(analisisDeRetardo);
+    audioProcessor.poolDeAnalisis->registra(analisisEstadistico);
+
+    audioProcessor.conectaConsumidorDelAnalizador();
+
     startTimerHz(60);
 }
 
 ComponenteAnalizador::~ComponenteAnalizador()
 {
+    audioProcessor.desconectaConsumidorDelAnalizador();
+
+    audioProcessor.poolDeAnalisis->elimina(productorOndaIzq);
+    audioProcessor.poolDeAnalisis->elimina(productorOndaDer);
+    audioProcessor.poolDeAnalisis->elimina(reanalisisCongelado);
+    audioProcessor.poolDeAnalisis->elimina(medidaConBarrido);
+    audioProcessor.poolDeAnalisis->elimina(analisisDeDistorsion);
+    audioProcessor.poolDeAnalisis->elimina(analisisEstereo);
+    audioProcessor.poolDeAnalisis->elimina(analisisDeRetardo);
+    audioProcessor.poolDeAnalisis->elimina(analisisEstadistico);
+
+    //sin editor nadie podria descongelarla, la captura vuelve a seguir la entrada
+    audioProcessor.capturaRetroactiva.descongela();
+
+    //ni ver el resultado de un barrido a medias, ni parar el tono de prueba
+    audioProcessor.barridoSinusoidal.cancela();
+    audioProcessor.barridoSinusoidal.paraTono();
+
     const auto& params = audioProcessor.getParameters();
     for (auto param : params)
     {
@@ -267,7 +302,7 @@ void ComponenteAnalizador::actualizaSe
     for (int i = 0; i < w; ++i)
     {
         double mag = 1.f;
-        auto freq = mapToLog10(double(i) / double(w), 20.0, 20000.0);
+        auto freq = (double)eje.aFrecuencia(float(i) / float(w));
 
         if (!cadena.isBypassed<PosicionCadenas::Pico>())
             mag *= pico.coefficients->getMagnitudeForFrequency(freq, sampleRate);
@@ -308,263 +343,3294 @@ void ComponenteAnalizador::actualizaSe
         return jmap(input, -24.0, 24.0, outputMin, outputMax);
     };
 
-    onda.startNewSubPath(responseArea.getX(), map(mags.front()));
+    onda.startNewSubPath(responseArea.getX(), map(mags.front()));
+
+    for (size_t i = 1; i < mags.size(); ++i)
+    {
+        onda.lineTo(responseArea.getX() + i, map(mags[i]));
+    }
+}
+
+void ComponenteAnalizador::paint(juce::Graphics& g)
+{
+    using namespace juce;
+    // (Rellenamos el findo con un color opaco)
+    g.fillAll(Colours::black);
+
+    drawBackgroundGrid(g);
+
+    auto responseArea = getAnalysisArea();
+
+    //en el modo de transferencia no hay espectros, la medida se dibuja sobre la curva teorica
+    if (shouldShowFFTAnalysis
+        && modoAnalizador != ModoAnalizador::Modo_Transferencia
+        && modoAnalizador != ModoAnalizador::Modo_Tercios)
+    {
+        //la entrada sin ecualizar va debajo, mas tenue, para comparar con lo que sale
+        if (mostrarPreEcualizacion)
+        {
+            auto preIzq = productorOndaIzq.getPathPreEcualizacion();
+            preIzq.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+
+            g.setColour(Colour(73u, 243u, 242u).withAlpha(0.35f));
+            g.strokePath(preIzq, PathStrokeType(1.f));
+
+            auto preDer = productorOndaDer.getPathPreEcualizacion();
+            preDer.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+
+            g.setColour(Colour(255u, 20u, 20u).withAlpha(0.35f));
+            g.strokePath(preDer, PathStrokeType(1.f));
+        }
+
+        if (vistaReferencia != VistaReferencia::Referencia_Apagada)
+            dibujaReferencia(g, responseArea);
+
+        auto sealFFTCanalIzq = productorOndaIzq.getPath();
+        sealFFTCanalIzq.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+
+        g.setColour(Colour(73u, 243u, 242u)); //turquesa neon
+        g.strokePath(sealFFTCanalIzq, PathStrokeType(1.f));
+
+        auto sealFFTCanalDer = productorOndaDer.getPath();
+        sealFFTCanalDer.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+
+        g.setColour(Colour(255u, 20u, 20u));//Rojo
+        g.strokePath(sealFFTCanalDer, PathStrokeType(1.f));
+
+        if (mostrarPicos)
+        {
+            auto picosIzq = productorOndaIzq.getPathPicos();
+            picosIzq.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+
+            g.setColour(Colour(73u, 243u, 242u).withAlpha(0.5f));
+            g.strokePath(picosIzq, PathStrokeType(1.f));
+
+            auto picosDer = productorOndaDer.getPathPicos();
+            picosDer.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+
+            g.setColour(Colour(255u, 20u, 20u).withAlpha(0.5f));
+            g.strokePath(picosDer, PathStrokeType(1.f));
+        }
+
+        dibujaPicosMarcados(g, responseArea);
+    }
+
+    if (shouldShowFFTAnalysis && modoAnalizador == ModoAnalizador::Modo_Tercios)
+        dibujaTercios(g, responseArea);
+
+    if (shouldShowFFTAnalysis && vistaEstereo != VistaEstereo::Estereo_Apagado)
+        dibujaEstereo(g, responseArea);
+
+    if (analisisEstadistico.estaActivo())
+        dibujaEstadistica(g, responseArea);
+
+    if (reanalisisCongelado.estaActivo())
+        dibujaCongelado(g, responseArea);
+
+    if (medidaConBarrido.estaActivo())
+        dibujaBarrido(g, responseArea);
+
+    if (analisisDeDistorsion.estaActivo())
+        dibujaDistorsion(g, responseArea);
+
+    if (analisisDeRetardo.estaActivo())
+        dibujaRetardo(g, responseArea);
+
+    if (mostrarSonoridad)
+        dibujaSonoridad(g, responseArea);
+
+    if (mostrarTonos)
+        dibujaTonos(g, responseArea);
+
+    g.setColour(Colours::white);
+    g.strokePath(onda, PathStrokeType(2.f));
+
+    if (shouldShowFFTAnalysis && modoAnalizador == ModoAnalizador::Modo_Transferencia)
+        dibujaTransferencia(g, responseArea);
+
+    if (seleccionandoZoom)
+    {
+        g.setColour(Colours::white.withAlpha(0.15f));
+        g.fillRect(Rectangle<int>(seleccionZoom.getStart(), responseArea.getY(),
+            seleccionZoom.getLength(), responseArea.getHeight()));
+    }
+
+    Path border;
+
+    border.setUsingNonZeroWinding(false);
+
+    border.addRoundedRectangle(getRenderArea(), 4);
+    border.addRectangle(getLocalBounds());
+
+    g.setColour(Colours::black);
+
+    g.fillPath(border);
+
+    drawTextLabels(g);
+
+    g.setColour(Colours::lavenderblush);
+    g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
+}
+
+std::vector<float> ComponenteAnalizador::getFrequencies()
+{
+    if (!eje.logaritmico)
+    {
+        //eje lineal del zoom: unas 5 marcas con paso 1, 2 o 5 x 10^n
+        auto pasoBruto = (eje.hasta - eje.desde) / 5.f;
+        auto potencia = std::pow(10.f, std::floor(std::log10(pasoBruto)));
+        auto paso = potencia * (pasoBruto >= 5.f * potencia ? 5.f : pasoBruto >= 2.f * potencia ? 2.f : 1.f);
+
+        std::vector<float> marcas;
+        for (auto f = std::ceil(eje.desde / paso) * paso; f <= eje.hasta; f += paso)
+            marcas.push_back(f);
+
+        return marcas;
+    }
+
+    return std::vector<float>
+    {
+        20, /*30, 40,*/ 50, 100,
+            200, /*300, 400,*/ 500, 1000,
+            2000, /*3000, 4000,*/ 5000, 10000,
+            20000
+    };
+}
+
+std::vector<float> ComponenteAnalizador::getGains()
+{
+    return std::vector<float>
+    {
+        -24, -12, 0, 12, 24
+    };
+}
+
+std::vector<float> ComponenteAnalizador::getXs(const std::vector<float>& freqs, float left, float width)
+{
+    std::vector<float> xs;
+    for (auto f : freqs)
+    {
+        auto normX = eje.aNormalizado(f);
+        xs.push_back(left + width * normX);
+    }
+
+    return xs;
+}
+
+void ComponenteAnalizador::drawBackgroundGrid(juce::Graphics& g)
+{
+    using namespace juce;
+    auto freqs = getFrequencies();
+
+    auto renderArea = getAnalysisArea();
+    auto left = renderArea.getX();
+    auto right = renderArea.getRight();
+    auto top = renderArea.getY();
+    auto bottom = renderArea.getBottom();
+    auto width = renderArea.getWidth();
+
+    auto xs = getXs(freqs, left, width);
+
+    g.setColour(Colours::dimgrey);
+    for (auto x : xs)
+    {
+        g.drawVerticalLine(x, top, bottom);
+    }
+
+    auto gain = getGains();
+
+    for (auto gDb : gain)
+    {
+        auto y = jmap(gDb, -24.f, 24.f, float(bottom), float(top));
+
+        g.setColour(gDb == 0.f ? Colour(0u, 172u, 1u) : Colours::darkgrey);
+        g.drawHorizontalLine(y, left, right);
+    }
+}
+
+void ComponenteAnalizador::drawTextLabels(juce::Graphics& g)
+{
+    using namespace juce;
+    g.setColour(Colours::lightgrey);
+    const int fontHeight = 10;
+    g.setFont(fontHeight);
+
+    auto renderArea = getAnalysisArea();
+    auto left = renderArea.getX();
+
+    auto top = renderArea.getY();
+    auto bottom = renderArea.getBottom();
+    auto width = renderArea.getWidth();
+
+    auto freqs = getFrequencies();
+    auto xs = getXs(freqs, left, width);
+
+    for (int i = 0; i < freqs.size(); ++i)
+    {
+        auto f = freqs[i];
+        auto x = xs[i];
+
+        bool addK = false;
+        String str;
+        if (f > 999.f)
+        {
+            addK = true;
+            f /= 1000.f;
+        }
+
+        str << f;
+        if (addK)
+            str << "k";
+        str << "Hz";
+
+        auto textWidth = g.getCurrentFont().getStringWidth(str);
+
+        Rectangle<int> r;
+
+        r.setSize(textWidth, fontHeight);
+        r.setCentre(x, 0);
+        r.setY(1);
+
+        g.drawFittedText(str, r, juce::Justification::centred, 1);
+    }
+
+    auto gain = getGains();
+
+    for (auto gDb : gain)
+    {
+        auto y = jmap(gDb, -24.f, 24.f, float(bottom), float(top));
+
+        String str;
+        if (gDb > 0)
+            str << "+";
+        str << gDb;
+
+        auto textWidth = g.getCurrentFont().getStringWidth(str);
+
+        Rectangle<int> r;
+        r.setSize(textWidth, fontHeight);
+        r.setX(getWidth() - textWidth);
+        r.setCentre(r.getCentreX(), y);
+
+        g.setColour(gDb == 0.f ? Colour(0u, 172u, 1u) : Colours::lightgrey);
+
+        g.drawFittedText(str, r, juce::Justification::centredLeft, 1);
+
+        str.clear();
+        str << (gDb - 24.f);
+
+        r.setX(1);
+        textWidth = g.getCurrentFont().getStringWidth(str);
+        r.setSize(textWidth, fontHeight);
+        g.setColour(Colours::lightgrey);
+        g.drawFittedText(str, r, juce::Justification::centredLeft, 1);
+    }
+}
+
+void ComponenteAnalizador::resized()
+{
+    using namespace juce;
+
+    onda.preallocateSpace(getWidth() * 3);
+    actualizaSeal();
+}
+
+void ComponenteAnalizador::dibujaPicosMarcados(juce::Graphics& g, juce::Rectangle<int> responseArea)
+{
+    using namespace juce;
+
+    //solo marcamos el canal izquierdo, con los dos la zona se llena de texto
+    auto picos = productorOndaIzq.getPicosEspectrales();
+
+    const int fontHeight = 10;
+    g.setFont(fontHeight);
+
+    for (int i = 0; i < picos.numPicos; ++i)
+    {
+        const auto& pico = picos.picos[(size_t)i];
+
+        //mismo mapeo que construyePath, desplazado a la zona de analisis
+        auto x = responseArea.getX() + eje.aNormalizado(pico.frecuencia) * responseArea.getWidth();
+        auto y = responseArea.getY() + jmap(pico.nivelDb, -48.f, 0.f, float(responseArea.getHeight() + 10), float(responseArea.getY()));
+
+        g.setColour(Colours::yellow);
+        g.fillEllipse(Rectangle<float>(5.f, 5.f).withCentre({ x, y }));
+
+        String str;
+        if (pico.frecuencia > 999.f)
+            str << String(pico.frecuencia / 1000.f, 2) << "kHz";
+        else
+            str << String(pico.frecuencia, 1) << "Hz";
+
+        str << " " << String(pico.nivelDb, 1) << "dB";
+
+        auto textWidth = g.getCurrentFont().getStringWidth(str);
+
+        Rectangle<int> r;
+        r.setSize(textWidth, fontHeight);
+        r.setCentre((int)x, (int)y - fontHeight);
+        r = r.constrainedWithin(responseArea);
+
+        g.setColour(Colours::lightgrey);
+        g.drawFittedText(str, r, juce::Justification::centred, 1);
+    }
+}
+
+void ComponenteAnalizador::dibujaTransferencia(juce::Graphics& g, juce::Rectangle<int> responseArea)
+{
+    using namespace juce;
+
+    //solo el canal izquierdo, las dos cadenas llevan los mismos filtros
+    const auto& medida = productorOndaIzq.getMedidaDeTransferencia();
+    const auto width = (int)medida.magnitudDb.size();
+
+    if (width == 0)
+        return;
+
+    const auto top = (float)responseArea.getY();
+    const auto bottom = (float)responseArea.getBottom();
+
+    Path magnitud, fase, coherencia;
+
+    for (int x = 0; x < width; ++x)
+    {
+        const auto px = float(responseArea.getX() + x);
+
+        //la misma escala de +-24 dB que la curva de actualizaSeal
+        const auto yMagnitud = jlimit(top, bottom, jmap(medida.magnitudDb[(size_t)x], -24.f, 24.f, bottom, top));
+        const auto yFase = jmap(medida.faseGrados[(size_t)x], -180.f, 180.f, bottom, top);
+        const auto yCoherencia = jmap(medida.coherencia[(size_t)x], 0.f, 1.f, bottom, top);
+
+        if (x == 0)
+        {
+            magnitud.startNewSubPath(px, yMagnitud);
+            fase.startNewSubPath(px, yFase);
+            coherencia.startNewSubPath(px, yCoherencia);
+            continue;
+        }
+
+        magnitud.lineTo(px, yMagnitud);
+        coherencia.lineTo(px, yCoherencia);
+
+        //al dar la vuelta de +180 a -180 no unimos los puntos
+        if (std::abs(medida.faseGrados[(size_t)x] - medida.faseGrados[(size_t)x - 1]) > 180.f)
+            fase.startNewSubPath(px, yFase);
+        else
+            fase.lineTo(px, yFase);
+    }
+
+    g.setColour(Colours::grey.withAlpha(0.6f));
+    g.strokePath(coherencia, PathStrokeType(1.f));
+
+    g.setColour(Colours::cornflowerblue.withAlpha(0.7f));
+    g.strokePath(fase, PathStrokeType(1.f));
+
+    g.setColour(Colours::lime);
+    g.strokePath(magnitud, PathStrokeType(1.5f));
+
+    auto leyenda = responseArea.reduced(4).removeFromTop(10);
+    g.setFont(10);
+
+    g.setColour(Colours::lime);
+    g.drawFittedText("|H|", leyenda.removeFromLeft(20), Justification::centredLeft, 1);
+    g.setColour(Colours::cornflowerblue);
+    g.drawFittedText("fase", leyenda.removeFromLeft(30), Justification::centredLeft, 1);
+    g.setColour(Colours::grey);
+    g.drawFittedText("coherencia", leyenda.removeFromLeft(60), Justification::centredLeft, 1);
+}
+
+void ComponenteAnalizador::dibujaTercios(juce::Graphics& g, juce::Rectangle<int> responseArea)
+{
+    using namespace juce;
+
+    const auto& izq = productorOndaIzq.getNivelesDeTercios();
+    const auto& der = productorOndaDer.getNivelesDeTercios();
+
+    const auto left = (float)responseArea.getX();
+    const auto width = (float)responseArea.getWidth();
+    const auto top = (float)responseArea.getY();
+    const auto bottom = (float)responseArea.getBottom();
+
+    //la misma escala que las trazas, -48 dB abajo del todo
+    auto mapY = [top, bottom](float db) { return jmap(jlimit(-48.f, 0.f, db), -48.f, 0.f, bottom, top); };
+
+    auto aX = [this, left, width](float frecuencia)
+    {
+        return left + width * eje.aNormalizado(jlimit(eje.desde, eje.hasta, frecuencia));
+    };
+
+    auto dibujaMitad = [&g, &mapY, bottom](float nivelDb, float picoDb, bool conPico, float desde, float hasta, Colour color)
+    {
+        g.setColour(color.withAlpha(0.6f));
+        g.fillRect(Rectangle<float>::leftTopRightBottom(desde, mapY(nivelDb), hasta, bottom));
+
+        if (conPico)
+        {
+            g.setColour(color);
+            g.fillRect(Rectangle<float>(desde, mapY(picoDb) - 1.f, hasta - desde, 2.f));
+        }
+    };
+
+    //cada banda ocupa sus bordes en el eje: la mitad izquierda para L y la derecha para R
+    for (int b = 0; b < NivelesDeTercios::numBandas; ++b)
+    {
+        if (!izq.disponibles[(size_t)b] || !der.disponibles[(size_t)b])
+            continue;
+
+        const auto x0 = aX(BancoDeTercios::getFrecuenciaInferior(b)) + 1.f;
+        const auto x1 = aX(BancoDeTercios::getFrecuenciaSuperior(b)) - 1.f;
+        const auto medio = 0.5f * (x0 + x1);
+
+        if (x1 <= x0)
+            continue;
+
+        dibujaMitad(izq.nivelesDb[(size_t)b], izq.picosDb[(size_t)b], izq.conPicos, x0, medio, Colour(73u, 243u, 242u));
+        dibujaMitad(der.nivelesDb[(size_t)b], der.picosDb[(size_t)b], der.conPicos, medio, x1, Colour(255u, 20u, 20u));
+    }
+}
+
+void ComponenteAnalizador::dibujaCongelado(juce::Graphics& g, juce::Rectangle<int> responseArea)
+{
+    using namespace juce;
+
+    auto congeladoIzq = reanalisisCongelado.getPath(Channel::Left);
+    congeladoIzq.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+
+    g.setColour(Colours::orange);
+    g.strokePath(congeladoIzq, PathStrokeType(1.5f));
+
+    auto congeladoDer = reanalisisCongelado.getPath(Channel::Right);
+    congeladoDer.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+
+    g.setColour(Colours::violet);
+    g.strokePath(congeladoDer, PathStrokeType(1.5f));
+
+    String str;
+    auto progreso = reanalisisCongelado.getProgreso();
+
+    if (progreso < 1.f)
+        str << "Analizando " << roundToInt(progreso * 100.f) << "%";
+    else if (reanalisisCongelado.getSegundosAnalizados() > 0.0)
+        str << "Congelado " << String(reanalisisCongelado.getSegundosAnalizados(), 1) << "s";
+    else
+        str << "Congelado, sin audio";
+
+    g.setFont(10);
+    g.setColour(Colours::orange);
+    g.drawFittedText(str, responseArea.reduced(4), Justification::topRight, 1);
+}
+
+void ComponenteAnalizador::dibujaBarrido(juce::Graphics& g, juce::Rectangle<int> responseArea)
+{
+    using namespace juce;
+
+    const auto& medida = medidaConBarrido.getMedida();
+
+    g.setFont(10);
+
+    String str;
+
+    if (audioProcessor.barridoSinusoidal.estaMidiendo())
+        str << "Barrido " << roundToInt(audioProcessor.barridoSinusoidal.getProgreso() * 100.f) << "%";
+    else if (medidaConBarrido.hayMedida())
+        str << "Barrido, retardo " << String(medida.retardoMs, 2) << "ms";
+    else if (audioProcessor.barridoSinusoidal.hayGrabacion() || medidaConBarrido.estaDeconvolucionando())
+        str << "Deconvolucionando";
+    else
+        str << "Barrido interrumpido";
+
+    g.setColour(Colours::gold);
+    g.drawFittedText(str, responseArea.reduced(4), Justification::bottomLeft, 1);
+
+    if (!medidaConBarrido.hayMedida())
+        return;
+
+    const auto top = (float)responseArea.getY();
+    const auto bottom = (float)responseArea.getBottom();
+
+    //el modulo en la misma escala de +-24 dB que la curva de actualizaSeal
+    auto dibujaRespuesta = [&](const std::vector<float>& respuestaDb, Colour colour)
+    {
+        if (respuestaDb.empty() || medida.ultimaColumna < medida.primeraColumna)
+            return;
+
+        Path respuesta;
+
+        for (int x = medida.primeraColumna; x <= medida.ultimaColumna; ++x)
+        {
+            const auto px = float(responseArea.getX() + x);
+            const auto py = jlimit(top, bottom, jmap(respuestaDb[(size_t)x], -24.f, 24.f, bottom, top));
+
+            if (x == medida.primeraColumna)
+                respuesta.startNewSubPath(px, py);
+            else
+                respuesta.lineTo(px, py);
+        }
+
+        g.setColour(colour);
+        g.strokePath(respuesta, PathStrokeType(1.5f));
+    };
+
+    dibujaRespuesta(medida.respuestaDb[(size_t)Channel::Right], Colours::hotpink);
+    dibujaRespuesta(medida.respuestaDb[(size_t)Channel::Left], Colours::gold);
+
+    //recuadro con el impulso abajo a la derecha
+    const auto columnas = (int)medida.impulsoMinimos.size();
+    auto recuadro = responseArea.reduced(4);
+    recuadro = recuadro.removeFromBottom(recuadro.getHeight() / 3).removeFromRight(columnas);
+
+    g.setColour(Colours::black.withAlpha(0.7f));
+    g.fillRect(recuadro);
+    g.setColour(Colours::dimgrey);
+    g.drawRect(recuadro);
+    g.drawHorizontalLine(recuadro.getCentreY(), (float)recuadro.getX(), (float)recuadro.getRight());
+
+    g.setColour(Colours::gold);
+    for (int x = 0; x < columnas; ++x)
+    {
+        const auto yMaximo = jmap(medida.impulsoMaximos[(size_t)x], -1.f, 1.f, (float)recuadro.getBottom(), (float)recuadro.getY());
+        const auto yMinimo = jmap(medida.impulsoMinimos[(size_t)x], -1.f, 1.f, (float)recuadro.getBottom(), (float)recuadro.getY());
+
+        g.drawVerticalLine(recuadro.getX() + x, yMaximo, jmax(yMinimo, yMaximo + 1.f));
+    }
+
+    g.drawFittedText("h(t)", recuadro.reduced(2), Justification::topLeft, 1);
+}
+
+void ComponenteAnalizador::dibujaDistorsion(juce::Graphics& g, juce::Rectangle<int> responseArea)
+{
+    using namespace juce;
+
+    const auto& resultado = analisisDeDistorsion.getResultado();
+
+    const int fontHeight = 10;
+    g.setFont(fontHeight);
+
+    auto panel = responseArea.reduced(4).removeFromLeft(150);
+
+    g.setColour(Colours::black.withAlpha(0.7f));
+    g.fillRect(panel);
+    g.setColour(Colours::dimgrey);
+    g.drawRect(panel);
+
+    panel.reduce(3, 2);
+
+    auto linea = [&](const String& str)
+    {
+        g.drawFittedText(str, panel.removeFromTop(fontHeight + 2), Justification::centredLeft, 1);
+    };
+
+    g.setColour(Colours::springgreen);
+    linea("Tono " + String(BarridoSinusoidal::frecuenciaTono, 0) + "Hz " + String(BarridoSinusoidal::nivelDb, 0) + "dBFS");
+
+    if (!resultado.valido)
+    {
+        g.setColour(Colours::lightgrey);
+        linea("sin tono de vuelta");
+        return;
+    }
+
+    g.setColour(Colours::lightgrey);
+    linea("F0 " + String(resultado.fundamentalHz, 2) + "Hz " + String(resultado.fundamentalDbFS, 1) + "dBFS");
+    linea("THD " + String(resultado.thdPorCiento, 4) + "% " + String(resultado.thdDb, 1) + "dB");
+    linea("THD+N " + String(resultado.thdnPorCiento, 4) + "% " + String(resultado.thdnDb, 1) + "dB");
+
+    //un palito por armonico, de -140 dBc abajo a 0 dBc arriba
+    auto barras = panel.reduced(0, 2);
+    auto etiquetas = barras.removeFromBottom(fontHeight);
+
+    const auto ancho = barras.getWidth() / ResultadoDeDistorsion::maxArmonicos;
+
+    for (int i = 0; i < resultado.numArmonicos; ++i)
+    {
+        auto barra = barras.withX(barras.getX() + i * ancho).withWidth(ancho).reduced(1, 0);
+        const auto y = jmap(jlimit(-140.f, 0.f, resultado.armonicosDb[(size_t)i]), -140.f, 0.f,
+            (float)barra.getBottom(), (float)barra.getY());
+
+        g.setColour(Colours::springgreen.withAlpha(0.8f));
+        g.fillRect(barra.toFloat().withTop(y));
+
+        g.setColour(Colours::lightgrey);
+        g.drawFittedText(String(i + 2), etiquetas.withX(barra.getX()).withWidth(barra.getWidth()), Justification::centred, 1);
+    }
+}
+
+void ComponenteAnalizador::dibujaEstereo(juce::Graphics& g, juce::Rectangle<int> responseArea)
+{
+    using namespace juce;
+
+    const auto& medida = analisisEstereo.getMedida();
+
+    const auto top = (float)responseArea.getY();
+    const auto bottom = (float)responseArea.getBottom();
+
+    auto leyenda = responseArea.reduced(4).removeFromTop(10).removeFromRight(120);
+    g.setFont(10);
+
+    if (vistaEstereo == VistaEstereo::Estereo_MedioLado)
+    {
+        auto medio = analisisEstereo.getPathMedio();
+        medio.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+
+        g.setColour(Colours::khaki);
+        g.strokePath(medio, PathStrokeType(1.5f));
+
+        auto lado = analisisEstereo.getPathLado();
+        lado.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+
+        g.setColour(Colours::mediumpurple);
+        g.strokePath(lado, PathStrokeType(1.5f));
+
+        g.setColour(Colours::khaki);
+        g.drawFittedText("medio", leyenda.removeFromLeft(35), Justification::centredLeft, 1);
+        g.setColour(Colours::mediumpurple);
+        g.drawFittedText("lado", leyenda.removeFromLeft(30), Justification::centredLeft, 1);
+    }
+    else
+    {
+        //la correlacion va de -1 abajo a +1 arriba, con el cero en medio; la coherencia de 0 a 1
+        const auto yCero = (top + bottom) * 0.5f;
+
+        g.setColour(Colours::aquamarine.withAlpha(0.3f));
+        g.drawHorizontalLine(roundToInt(yCero), (float)responseArea.getX(), (float)responseArea.getRight());
+
+        const auto width = (int)medida.correlacion.size();
+        Path correlacion, coherencia;
+
+        for (int x = 0; x < width; ++x)
+        {
+            const auto px = float(responseArea.getX() + x);
+            const auto yCorrelacion = jmap(medida.correlacion[(size_t)x], -1.f, 1.f, bottom, top);
+            const auto yCoherencia = jmap(medida.coherencia[(size_t)x], 0.f, 1.f, bottom, top);
+
+            if (x == 0)
+            {
+                correlacion.startNewSubPath(px, yCorrelacion);
+                coherencia.startNewSubPath(px, yCoherencia);
+                continue;
+            }
+
+            correlacion.lineTo(px, yCorrelacion);
+            coherencia.lineTo(px, yCoherencia);
+        }
+
+        g.setColour(Colours::grey.withAlpha(0.6f));
+        g.strokePath(coherencia, PathStrokeType(1.f));
+
+        g.setColour(Colours::aquamarine);
+        g.strokePath(correlacion, PathStrokeType(1.5f));
+
+        g.setColour(Colours::aquamarine);
+        g.drawFittedText("correlacion", leyenda.removeFromLeft(60), Justification::centredLeft, 1);
+        g.setColour(Colours::grey);
+        g.drawFittedText("coherencia", leyenda.removeFromLeft(60), Justification::centredLeft, 1);
+    }
+
+    //medidor de correlacion de toda la banda, abajo a la derecha, con el cero en el centro
+    auto medidor = responseArea.reduced(4).removeFromBottom(10).removeFromRight(150);
+    auto texto = medidor.removeFromLeft(55);
+    const auto valor = medida.correlacionGlobal;
+
+    g.setColour(Colours::black.withAlpha(0.7f));
+    g.fillRect(medidor);
+
+    const auto centro = (float)medidor.getCentreX();
+    const auto extremo = jmap(valor, -1.f, 1.f, (float)medidor.getX(), (float)medidor.getRight());
+
+    g.setColour(valor < 0.f ? Colours::red : Colours::limegreen);
+    g.fillRect(Rectangle<float>::leftTopRightBottom(jmin(centro, extremo), (float)medidor.getY(),
+        jmax(centro, extremo), (float)medidor.getBottom()));
+
+    g.setColour(Colours::dimgrey);
+    g.drawRect(medidor);
+    g.drawVerticalLine(medidor.getCentreX(), (float)medidor.getY(), (float)medidor.getBottom());
+
+    g.setColour(Colours::lightgrey);
+    g.drawFittedText("Corr " + String(valor >= 0.f ? "+" : "") + String(valor, 2), texto, Justification::centredLeft, 1);
+}
+
+void ComponenteAnalizador::dibujaRetardo(juce::Graphics& g, juce::Rectangle<int> responseArea)
+{
+    using namespace juce;
+
+    const auto& resultado = analisisDeRetardo.getResultado();
+
+    const int fontHeight = 10;
+    g.setFont(fontHeight);
+
+    //arriba a la derecha, debajo de la leyenda de la vista estereo
+    auto panel = responseArea.reduced(4).withTrimmedTop(fontHeight + 4).removeFromTop(3 * (fontHeight + 2) + 4).removeFromRight(120);
+
+    g.setColour(Colours::black.withAlpha(0.7f));
+    g.fillRect(panel);
+    g.setColour(Colours::dimgrey);
+    g.drawRect(panel);
+
+    panel.reduce(3, 2);
+
+    auto linea = [&](const String& str)
+    {
+        g.drawFittedText(str, panel.removeFromTop(fontHeight + 2), Justification::centredLeft, 1);
+    };
+
+    g.setColour(Colours::plum);
+    linea("Retardo R respecto a L");
+
+    if (!resultado.valido)
+    {
+        g.setColour(Colours::lightgrey);
+        linea("sin senal");
+        return;
+    }
+
+    //con poca confianza el numero esta ahi, pero atenuado
+    g.setColour(Colours::lightgrey.withAlpha(resultado.confianza < 0.3f ? 0.5f : 1.f));
+
+    auto conSigno = [](float valor, int decimales) { return String(valor >= 0.f ? "+" : "") + String(valor, decimales); };
+
+    linea(conSigno(resultado.retardoMs, 3) + "ms " + conSigno(resultado.retardoMuestras, 2) + " muestras");
+    linea("confianza " + String(resultado.confianza, 2));
+}
+
+void ComponenteAnalizador::dibujaSonoridad(juce::Graphics& g, juce::Rectangle<int> responseArea)
+{
+    using namespace juce;
+
+    const auto& medidor = audioProcessor.medidorDeSonoridad;
+
+    const int fontHeight = 10;
+    g.setFont(fontHeight);
+
+    //abajo en el centro, entre el estado del barrido y el medidor de correlacion
+    auto panel = responseArea.reduced(4).removeFromBottom(2 * (fontHeight + 2) + 4 + 14).removeFromTop(2 * (fontHeight + 2) + 4);
+    panel = panel.withSizeKeepingCentre(170, panel.getHeight());
+
+    g.setColour(Colours::black.withAlpha(0.7f));
+    g.fillRect(panel);
+    g.setColour(Colours::dimgrey);
+    g.drawRect(panel);
+
+    panel.reduce(3, 2);
+
+    //por debajo de la puerta absoluta no hay medida
+    auto valor = [](float v) { return v > -70.f ? String(v, 1) : String("--"); };
+
+    g.setColour(Colours::gold);
+    g.drawFittedText("M " + valor(medidor.getMomentaneo())
+        + "  S " + valor(medidor.getCortoPlazo())
+        + "  I " + valor(medidor.getIntegrado()) + " LUFS",
+        panel.removeFromTop(fontHeight + 2), Justification::centredLeft, 1);
+
+    const auto pico = medidor.getPicoVerdadero();
+    auto fila = panel.removeFromTop(fontHeight + 2);
+
+    g.setColour(Colours::lightgrey);
+    g.drawFittedText("LRA " + String(medidor.getRango(), 1) + " LU", fila.removeFromLeft(80), Justification::centredLeft, 1);
+
+    //por encima de -1 dBTP, el maximo de R128, el pico se pinta en rojo
+    g.setColour(pico > -1.f ? Colours::red : Colours::lightgrey);
+    g.drawFittedText("TP " + (pico > MedidorDeSonoridad::sinMedida ? String(pico, 1) : String("--")) + " dBTP",
+        fila, Justification::centredLeft, 1);
+}
+
+void ComponenteAnalizador::dibujaTonos(juce::Graphics& g, juce::Rectangle<int> responseArea)
+{
+    using namespace juce;
+
+    const auto& rastreador = audioProcessor.rastreadorDeTonos;
+    const auto numTonos = rastreador.getNumTonos();
+
+    if (numTonos == 0)
+        return;
+
+    const auto top = (float)responseArea.getY();
+    const auto bottom = (float)responseArea.getBottom();
+
+    //la misma escala que las trazas; por debajo de -48 dB la marca se queda abajo
+    auto mapY = [top, bottom](float db) { return jmap(jlimit(-48.f, 0.f, db), -48.f, 0.f, bottom, top); };
+
+    //una linea por tono y una raya a la altura del nivel de cada canal
+    for (int t = 0; t < numTonos; ++t)
+    {
+        const auto frecuencia = rastreador.getFrecuencia(t);
+
+        if (frecuencia < eje.desde || frecuencia > eje.hasta)
+            continue;
+
+        const auto x = (float)responseArea.getX() + (float)responseArea.getWidth() * eje.aNormalizado(frecuencia);
+
+        g.setColour(Colours::yellow.withAlpha(0.3f));
+        g.drawVerticalLine(roundToInt(x), top, bottom);
+
+        const std::array<Colour, RastreadorDeTonos::numCanales> colores{ Colour(73u, 243u, 242u), Colour(255u, 20u, 20u) };
+
+        for (int c = 0; c < RastreadorDeTonos::numCanales; ++c)
+        {
+            const auto nivel = rastreador.getNivel(c, t);
+
+            if (nivel <= RastreadorDeTonos::sinMedida)
+                continue;
+
+            g.setColour(colores[(size_t)c]);
+            g.fillRect(Rectangle<float>(x - 4.f, mapY(nivel) - 1.f, 8.f, 2.f));
+        }
+    }
+
+    //arriba en el centro, el nivel del canal mas alto de cada tono; cuatro por fila
+    const int fontHeight = 10;
+    const int anchoCelda = 62;
+    const auto columnas = jmin(4, numTonos);
+    const auto filas = (numTonos + 3) / 4;
+
+    g.setFont(fontHeight);
+
+    auto panel = responseArea.reduced(4).removeFromTop(filas * (fontHeight + 2) + 4);
+    panel = panel.withSizeKeepingCentre(columnas * anchoCelda + 6, panel.getHeight());
+
+    g.setColour(Colours::black.withAlpha(0.7f));
+    g.fillRect(panel);
+    g.setColour(Colours::dimgrey);
+    g.drawRect(panel);
+
+    panel.reduce(3, 2);
+
+    for (int t = 0; t < numTonos; ++t)
+    {
+        const auto nivel = jmax(rastreador.getNivel(0, t), rastreador.getNivel(1, t));
+        const auto frecuencia = rastreador.getFrecuencia(t);
+
+        auto celda = Rectangle<int>(panel.getX() + (t % 4) * anchoCelda, panel.getY() + (t / 4) * (fontHeight + 2),
+            anchoCelda, fontHeight + 2);
+
+        g.setColour(Colours::yellow);
+        g.drawFittedText(String(frecuencia, frecuencia < 100.f ? 1 : 0)
+            + " " + (nivel > RastreadorDeTonos::sinMedida ? String(nivel, 1) : String("--")),
+            celda, Justification::centredLeft, 1);
+    }
+}
+
+void ComponenteAnalizador::dibujaEstadistica(juce::Graphics& g, juce::Rectangle<int> responseArea)
+{
+    using namespace juce;
+
+    const auto traslacion = AffineTransform().translation(responseArea.getX(), responseArea.getY());
+
+    //P10 y P90 finos, la mediana encima
+    for (int p = 0; p < EstadisticaEspectral::numPercentiles; ++p)
+    {
+        auto percentil = analisisEstadistico.getPathPercentil(p);
+        percentil.applyTransform(traslacion);
+
+        const auto esMediana = p == EstadisticaEspectral::numPercentiles / 2;
+
+        g.setColour(esMediana ? Colours::wheat : Colours::wheat.withAlpha(0.5f));
+        g.strokePath(percentil, PathStrokeType(esMediana ? 1.5f : 1.f));
+    }
+
+    auto suelo = analisisEstadistico.getPathSuelo();
+    suelo.applyTransform(traslacion);
+
+    g.setColour(Colours::tomato);
+    g.strokePath(suelo, PathStrokeType(1.f));
+
+    //abajo a la izquierda, encima del estado del barrido
+    const int fontHeight = 10;
+    auto leyenda = responseArea.reduced(4).withTrimmedBottom(fontHeight + 4).removeFromBottom(fontHeight).removeFromLeft(200);
+
+    g.setFont(fontHeight);
+
+    g.setColour(Colours::wheat);
+    g.drawFittedText("P10/P50/P90", leyenda.removeFromLeft(65), Justification::centredLeft, 1);
+    g.setColour(Colours::tomato);
+    g.drawFittedText("suelo", leyenda.removeFromLeft(35), Justification::centredLeft, 1);
+
+    const auto segundos = roundToInt(analisisEstadistico.getSegundosAnalizados());
+
+    g.setColour(Colours::lightgrey);
+    g.drawFittedText(String(segundos / 60) + ":" + String(segundos % 60).paddedLeft('0', 2),
+        leyenda, Justification::centredLeft, 1);
+}
+
+void ComponenteAnalizador::dibujaReferencia(juce::Graphics& g, juce::Rectangle<int> responseArea)
+{
+    using namespace juce;
+
+    const auto traslacion = AffineTransform().translation(responseArea.getX(), responseArea.getY());
+    const std::array<ProductorDeOndas*, 2> productores{ &productorOndaIzq, &productorOndaDer };
+    const std::array<Colour, 2> colores{ Colour(73u, 243u, 242u), Colour(255u, 20u, 20u) };
+
+    //la referencia a trazos, para no confundirla con la salida
+    const float trazos[] = { 4.f, 3.f };
+
+    for (size_t c = 0; c < productores.size(); ++c)
+    {
+        auto referencia = productores[c]->getPathReferencia();
+        referencia.applyTransform(traslacion);
+
+        Path discontinua;
+        PathStrokeType(1.f).createDashedStroke(discontinua, referencia, trazos, 2);
+
+        g.setColour(colores[c].withAlpha(0.6f));
+        g.fillPath(discontinua);
+
+        //la diferencia va en la escala de la curva del EQ
+        if (vistaReferencia == VistaReferencia::Referencia_ConDiferencia)
+        {
+            auto diferencia = productores[c]->getPathDiferencia();
+            diferencia.applyTransform(traslacion);
+
+            g.setColour(colores[c].interpolatedWith(Colours::white, 0.5f));
+            g.strokePath(diferencia, PathStrokeType(1.5f));
+        }
+    }
+
+    //abajo a la izquierda, encima de la leyenda de la estadistica
+    const int fontHeight = 10;
+    auto leyenda = responseArea.reduced(4).withTrimmedBottom(2 * (fontHeight + 4)).removeFromBottom(fontHeight).removeFromLeft(200);
+
+    g.setFont(fontHeight);
+    g.setColour(Colours::lightgrey);
+
+    if (!audioProcessor.tieneEntradaDeReferencia())
+        g.drawFittedText("sin entrada de referencia", leyenda, Justification::centredLeft, 1);
+    else if (vistaReferencia == VistaReferencia::Referencia_ConDiferencia)
+        g.drawFittedText("referencia a trazos, salida - ref. +-24 dB", leyenda, Justification::centredLeft, 1);
+    else
+        g.drawFittedText("referencia a trazos", leyenda, Justification::centredLeft, 1);
+}
+
+void ComponenteAnalizador::setBarrido(bool medir)
+{
+    if (medir == medidaConBarrido.estaActivo())
+        return;
+
+    auto& barrido = audioProcessor.barridoSinusoidal;
+
+    if (medir)
+    {
+        auto destino = static_cast<DestinoBarrido>((int)audioProcessor.apvts.getRawParameterValue("Destino Barrido")->load());
+
+        barrido.inicia(destino);
+        medidaConBarrido.empieza();
+    }
+    else
+    {
+        medidaConBarrido.cancela();
+        barrido.cancela();
+    }
+
+    audioProcessor.poolDeAnalisis->notifica();
+    repaint();
+}
+
+void ComponenteAnalizador::setDistorsion(bool medir)
+{
+    if (medir == analisisDeDistorsion.estaActivo())
+        return;
+
+    auto& barrido = audioProcessor.barridoSinusoidal;
+
+    if (medir)
+    {
+        auto destino = static_cast<DestinoBarrido>((int)audioProcessor.apvts.getRawParameterValue("Destino Barrido")->load());
+
+        barrido.iniciaTono(destino);
+        analisisDeDistorsion.setActivo(true);
+    }
+    else
+    {
+        analisisDeDistorsion.setActivo(false);
+        barrido.paraTono();
+    }
+
+    audioProcessor.poolDeAnalisis->notifica();
+    repaint();
+}
+
+void ComponenteAnalizador::setCongelado(bool congelar)
+{
+    if (congelar == reanalisisCongelado.estaActivo())
+        return;
+
+    auto& captura = audioProcessor.capturaRetroactiva;
+
+    if (congelar)
+    {
+        captura.congela();
+        reanalisisCongelado.empieza();
+    }
+    else
+    {
+        reanalisisCongelado.cancela();
+        captura.descongela();
+    }
+
+    audioProcessor.poolDeAnalisis->notifica();
+    repaint();
+}
+
+void ComponenteAnalizador::mouseDown(const juce::MouseEvent& e)
+{
+    if (e.mods.isPopupMenu())
+    {
+        alternaTonoDeUsuario(e.x);
+        return;
+    }
+
+    seleccionZoom = { e.x, e.x };
+    seleccionandoZoom = true;
+}
+
+void ComponenteAnalizador::mouseDrag(const juce::MouseEvent& e)
+{
+    if (!seleccionandoZoom)
+        return;
+
+    auto area = getAnalysisArea();
+    auto x = juce::jlimit(area.getX(), area.getRight(), e.x);
+
+    seleccionZoom = juce::Range<int>::between(e.getMouseDownX(), x).getIntersectionWith({ area.getX(), area.getRight() });
+    repaint();
+}
+
+void ComponenteAnalizador::mouseUp(const juce::MouseEvent& e)
+{
+    juce::ignoreUnused(e);
+
+    if (!seleccionandoZoom)
+        return;
+
+    seleccionandoZoom = false;
+    repaint();
+
+    if (seleccionZoom.getLength() < 4)
+        return;
+
+    auto area = getAnalysisArea();
+    auto desde = eje.aFrecuencia(float(seleccionZoom.getStart() - area.getX()) / float(area.getWidth()));
+    auto hasta = eje.aFrecuencia(float(seleccionZoom.getEnd() - area.getX()) / float(area.getWidth()));
+
+    setParametro("Zoom Desde", desde);
+    setParametro("Zoom Hasta", hasta);
+    setParametro("Modo Analizador", (float)ModoAnalizador::Modo_Zoom);
+}
+
+void ComponenteAnalizador::mouseDoubleClick(const juce::MouseEvent& e)
+{
+    juce::ignoreUnused(e);
+    setParametro("Modo Analizador", (float)ModoAnalizador::Modo_Normal);
+}
+
+void ComponenteAnalizador::setParametro(const juce::String& id, float valor)
+{
+    if (auto* param = audioProcessor.apvts.getParameter(id))
+    {
+        param->beginChangeGesture();
+        param->setValueNotifyingHost(param->convertTo0to1(valor));
+        param->endChangeGesture();
+    }
+}
+
+void ComponenteAnalizador::alternaTonoDeUsuario(int x)
+{
+    auto area = getAnalysisArea();
+
+    if (x < area.getX() || x > area.getRight())
+        return;
+
+    auto aX = [this, &area](float frecuencia) { return float(area.getX()) + float(area.getWidth()) * eje.aNormalizado(frecuencia); };
+
+    //un tono a menos de 4 pixeles del click se quita
+    for (auto* id : idsTonosDeUsuario)
+    {
+        const auto tono = audioProcessor.apvts.getRawParameterValue(id)->load();
+
+        if (tono > 0.f && std::abs(aX(tono) - float(x)) <= 4.f)
+        {
+            setParametro(id, 0.f);
+            return;
+        }
+    }
+
+    for (auto* id : idsTonosDeUsuario)
+    {
+        if (audioProcessor.apvts.getRawParameterValue(id)->load() > 0.f)
+            continue;
+
+        setParametro(id, eje.aFrecuencia(float(x - area.getX()) / float(area.getWidth())));
+
+        if (!mostrarTonos)
+            setParametro("Rastreo de Tonos", (float)RastreoDeTonos::Rastreo_SoloTonos);
+
+        return;
+    }
+}
+
+void ComponenteAnalizador::parameterValueChanged(int parameterIndex, float newValue)
+{
+    parametrosModificados.set(true);
+}
+
+//ancho de bin de 2048 puntos a 48 kHz, se mantiene a cualquier frecuencia de muestreo
+static constexpr double anchoDeBinObjetivo = 48000.0 / 2048.0;
+
+//un bloque con pico por debajo de esto no puede subir ningun bin por encima del suelo de -48 dB
+static const float umbralDeSilencio = juce::Decibels::decibelsToGain(-48.f - 6.f);
+
+static int getFactorDeDiezmado(double sampleRate)
+{
+    return juce::jmax(1, (int)std::round(sampleRate / 48000.0));
+}
+
+static FFTOrder eligeOrdenFFT(double frecuenciaDeAnalisis)
+{
+    auto orden = (int)std::round(std::log2(frecuenciaDeAnalisis / anchoDeBinObjetivo));
+    return static_cast<FFTOrder>(juce::jlimit((int)FFTOrder::order1024, (int)FFTOrder::order16384, orden));
+}
+
+void ProductorDeOndas::preparaAnalisis(ModoAnalizador nuevoModo, double sampleRate)
+{
+    if (nuevoModo == modo && sampleRate == frecuenciaPreparada)
+        return;
+
+    if (sampleRate != frecuenciaPreparada)
+    {
+        frecuenciaPreparada = sampleRate;
+
+        auto factor = getFactorDeDiezmado(sampleRate);
+        frecuenciaDeAnalisis = sampleRate / factor;
+
+        std::vector<float> coeficientes{ 1.f };
+
+        if (factor > 1)
+        {
+            //corte justo por debajo del nuevo Nyquist, lo que se pliega cae por encima de 20 kHz
+            auto fir = juce::dsp::FilterDesign<float>::designFIRLowpassKaiserMethod(float(0.46 * frecuenciaDeAnalisis),
+                sampleRate,
+                float(0.08 * frecuenciaDeAnalisis / sampleRate),
+                -80.f);
+
+            coeficientes.assign(fir->coefficients.begin(), fir->coefficients.end());
+        }
+
+        diezmador.prepare(factor, coeficientes);
+        generadorDatosFFTCanalIzq.changeOrder(eligeOrdenFFT(frecuenciaDeAnalisis));
+
+        diezmadorPre.prepare(factor, coeficientes);
+        generadorPreEcualizacion.comparteTransformadaDe(generadorDatosFFTCanalIzq);
+
+        diezmadorReferencia.prepare(factor, coeficientes);
+        generadorReferencia.comparteTransformadaDe(generadorDatosFFTCanalIzq);
+        historialReferencia.setSize(1, generadorReferencia.getFFTSize());
+    }
+
+    modo = nuevoModo;
+
+    if (modo == ModoAnalizador::Modo_MultiResolucion && !bandasPreparadas)
+    {
+        //se crean aqui, en el hilo de analisis, para no medir los motores FFT al abrir el editor
+        const std::array<FFTOrder, 3> ordenes{ FFTOrder::order16384, FFTOrder::order4096, FFTOrder::order1024 };
+
+        for (size_t b = 0; b < bandasMultiResolucion.size(); ++b)
+            bandasMultiResolucion[b].generador.changeOrder(ordenes[b]);
+
+        bandasPreparadas = true;
+    }
+
+    //tambien se crea al entrar en el modo por primera vez, prepare() no hace nada si ya esta
+    if (modo == ModoAnalizador::Modo_Reasignado)
+        espectroReasignado.prepare(FFTOrder::order2048);
+
+    //16k puntos: la resolucion de los cortes de graves importa mas que la velocidad de refresco
+    if (modo == ModoAnalizador::Modo_Transferencia)
+        funcionDeTransferencia.prepare(FFTOrder::order16384);
+
+    //el banco trabaja sobre la seal ya diezmada, por encima de 48 kHz no hay bandas que medir
+    if (modo == ModoAnalizador::Modo_Tercios && bancoDeTercios.necesitaPreparar(frecuenciaDeAnalisis))
+        bancoDeTercios.prepare(frecuenciaDeAnalisis);
+
+    for (auto& banda : bandasMultiResolucion)
+    {
+        banda.ultimoDato.clear();
+        banda.ultimoPico.clear();
+        banda.muestrasPendientes = 0;
+    }
+
+    muestrasEnSilencio = 0;
+    reasignadoEnSuelo = false;
+    limitesDelSuelo = {};
+
+    auto tamaoHistorial = generadorDatosFFTCanalIzq.getFFTSize();
+
+    if (modo == ModoAnalizador::Modo_MultiResolucion)
+        tamaoHistorial = bandasMultiResolucion.front().generador.getFFTSize();
+    else if (modo == ModoAnalizador::Modo_Reasignado)
+        tamaoHistorial = espectroReasignado.getFFTSize();
+    else if (modo == ModoAnalizador::Modo_Transferencia)
+        tamaoHistorial = funcionDeTransferencia.getFFTSize();
+
+    //la entrada sin ecualizar lleva un historial igual que el de la salida
+    monoBuffer.setSize(1, tamaoHistorial);
+    historialPre.setSize(1, tamaoHistorial);
+
+    reiniciaHistorial();
+    reiniciaReferencia();
+}
+
+void ProductorDeOndas::aadeAlHistorial(juce::AudioBuffer<float>& historial, const float* muestras, int numMuestras)
+{
+    auto size = juce::jmin(numMuestras, historial.getNumSamples());
+
+    juce::FloatVectorOperations::copy(historial.getWritePointer(0, 0),
+        historial.getReadPointer(0, size),
+        historial.getNumSamples() - size);
+
+    juce::FloatVectorOperations::copy(historial.getWritePointer(0, historial.getNumSamples() - size),
+        muestras + numMuestras - size,
+        size);
+}
+
+void ProductorDeOndas::procesaMultiResolucion(int muestrasNuevas, juce::Rectangle<float> fftBounds, bool silencioso)
+{
+    const std::array<float, 3> cortes{ 200.f, 2000.f, 0.f };
+
+    bool hayDatosNuevos = false;
+    auto* finHistorial = monoBuffer.getReadPointer(0) + monoBuffer.getNumSamples();
+
+    for (auto& banda : bandasMultiResolucion)
+    {
+        const auto fftSize = banda.generador.getFFTSize();
+        const auto salto = fftSize / 4;
+
+        banda.muestrasPendientes += muestrasNuevas;
+
+        if (banda.muestrasPendientes < salto)
+            continue;
+
+        const auto duracionDelFrame = double(banda.muestrasPendientes) / frecuenciaDeAnalisis;
+
+        //si el bloque es mayor que el salto no tiene sentido transformar dos veces lo mismo
+        banda.muestrasPendientes %= salto;
+
+        if (silencioso)
+        {
+            if (!banda.generador.produceTramaSilenciosa(-48.f, duracionDelFrame))
+                continue;
+        }
+        else
+        {
+            banda.generador.produceFFTDataForRendering(finHistorial - fftSize, -48.f, duracionDelFrame);
+        }
+
+        while (banda.generador.getNumAvailableFFTDataBlocks() > 0)
+            banda.generador.getFFTData(banda.ultimoDato);
+
+        banda.ultimoPico.clear();
+        while (banda.generador.getNumAvailablePeakBlocks() > 0)
+            banda.generador.getPeakData(banda.ultimoPico);
+
+        hayDatosNuevos = true;
+    }
+
+    if (!hayDatosNuevos)
+    {
+        if (silencioso && std::all_of(bandasMultiResolucion.begin(), bandasMultiResolucion.end(),
+            [](const BandaMultiResolucion& banda) { return banda.generador.estaEnSuelo(); }))
+        {
+            publicaSuelo(fftBounds);
+        }
+
+        return;
+    }
+
+    bandasParaDibujar.clear();
+
+    for (size_t b = 0; b < bandasMultiResolucion.size(); ++b)
+    {
+        const auto& banda = bandasMultiResolucion[b];
+
+        //hasta que la banda grande complete su primer salto no hay traza completa
+        if (banda.ultimoDato.empty())
+            return;
+
+        const auto fftSize = banda.generador.getFFTSize();
+        bandasParaDibujar.push_back({ &banda.ultimoDato, fftSize, float(frecuenciaDeAnalisis / double(fftSize)), cortes[b] });
+    }
+
+    productorDeSeal.generatePathMultiResolucion(bandasParaDibujar, fftBounds, -48.f);
+
+    //cada banda aporta los picos del tramo que dibuja
+    PicosEspectrales picos;
+    auto desde = 20.f;
+
+    for (const auto& banda : bandasParaDibujar)
+    {
+        auto hasta = banda.frecuenciaDeCorte > 0.f ? banda.frecuenciaDeCorte : 20000.f;
+        detectorDePicos.busca(banda.renderData->data(), banda.fftSize / 2, banda.binWidth, 0.f, desde, hasta, picos);
+        desde = hasta;
+    }
+
+    picosFifo.push(picos);
+
+    //justo al activar o desactivar la retencion no todas las bandas tienen picos todavia
+    if (std::any_of(bandasMultiResolucion.begin(), bandasMultiResolucion.end(),
+        [](const BandaMultiResolucion& banda) { return banda.ultimoPico.empty(); }))
+    {
+        return;
+    }
+
+    for (size_t b = 0; b < bandasParaDibujar.size(); ++b)
+        bandasParaDibujar[b].renderData = &bandasMultiResolucion[b].ultimoPico;
+
+    productorDePicos.generatePathMultiResolucion(bandasParaDibujar, fftBounds, -48.f);
+}
+
+void AnalizadorZoom::prepare(double frecuenciaDeEntrada, float desde, float hasta)
+{
+    frecuenciaEntrada = frecuenciaDeEntrada;
+    zoomDesde = desde;
+    zoomHasta = hasta;
+
+    const auto ancho = double(hasta - desde);
+    frecuenciaCentral = 0.5 * double(desde + hasta);
+
+    //la seal compleja diezmada tiene que cubrir toda la banda con algo de margen
+    auto restante = juce::jmax(1, (int)std::floor(frecuenciaDeEntrada / (1.25 * ancho)));
+    auto frecuenciaEtapa = frecuenciaDeEntrada;
+
+    etapasI.clear();
+    etapasQ.clear();
+
+    while (restante >= 2)
+    {
+        auto factor = juce::jmin(8, restante);
+        restante /= factor;
+
+        auto salida = frecuenciaEtapa / factor;
+
+        //protegemos +-ancho/2 alrededor de 0 Hz, lo que se pliega encima empieza en salida - ancho/2
+        auto fir = juce::dsp::FilterDesign<float>::designFIRLowpassKaiserMethod(float(0.5 * salida),
+            frecuenciaEtapa,
+            float((salida - ancho) / frecuenciaEtapa),
+            -80.f);
+
+        std::vector<float> coeficientes(fir->coefficients.begin(), fir->coefficients.end());
+
+        etapasI.emplace_back().prepare(factor, coeficientes);
+        etapasQ.emplace_back().prepare(factor, coeficientes);
+
+        frecuenciaEtapa = salida;
+    }
+
+    frecuenciaSalida = frecuenciaEtapa;
+
+    fasor = { 1.0, 0.0 };
+    rotacion = std::polar(1.0, -juce::MathConstants<double>::twoPi * frecuenciaCentral / frecuenciaDeEntrada);
+
+    const auto numBins = getNumBins();
+
+    historialI.assign(size_t(numBins), 0.f);
+    historialQ.assign(size_t(numBins), 0.f);
+    muestrasPendientes = 0;
+
+    fft = std::make_unique<juce::dsp::FFT>(ordenFFT);
+
+    ventana.resize(size_t(numBins));
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(ventana.data(),
+        size_t(numBins),
+        juce::dsp::WindowingFunction<float>::blackmanHarris);
+
+    entradaFFT.resize(size_t(numBins));
+    salidaFFT.resize(size_t(numBins));
+}
+
+bool AnalizadorZoom::process(const float* muestras,
+    int numMuestras,
+    std::vector<float>& espectroDb,
+    std::vector<float>& picosDb,
+    float negativeInfinity)
+{
+    if (fft == nullptr)
+        return false;
+
+    if ((int)bufferI.size() < numMuestras)
+    {
+        bufferI.resize(size_t(numMuestras));
+        bufferQ.resize(size_t(numMuestras));
+    }
+
+    for (int i = 0; i < numMuestras; ++i)
+    {
+        bufferI[size_t(i)] = muestras[i] * (float)fasor.real();
+        bufferQ[size_t(i)] = muestras[i] * (float)fasor.imag();
+        fasor *= rotacion;
+    }
+
+    //evitamos que el fasor se vaya alejando del circulo unidad por redondeo
+    fasor /= std::abs(fasor);
+
+    auto numSalidas = numMuestras;
+    for (size_t etapa = 0; etapa < etapasI.size(); ++etapa)
+    {
+        etapasQ[etapa].process(bufferQ.data(), numSalidas, bufferQ.data());
+        numSalidas = etapasI[etapa].process(bufferI.data(), numSalidas, bufferI.data());
+    }
+
+    if (numSalidas == 0)
+        return false;
+
+    const auto numBins = getNumBins();
+    const auto nuevas = juce::jmin(numSalidas, numBins);
+
+    for (auto* canal : { &historialI, &historialQ })
+    {
+        const auto& origen = canal == &historialI ? bufferI : bufferQ;
+        std::copy(canal->begin() + nuevas, canal->end(), canal->begin());
+        std::copy(origen.begin() + (numSalidas - nuevas), origen.begin() + numSalidas, canal->end() - nuevas);
+    }
+
+    muestrasPendientes += numSalidas;
+
+    const auto salto = numBins / 16;
+    if (muestrasPendientes < salto)
+        return false;
+
+    const auto duracionDelFrame = double(muestrasPendientes) / frecuenciaSalida;
+    muestrasPendientes %= salto;
+
+    calculaEspectro(espectroDb, picosDb, duracionDelFrame, negativeInfinity);
+    return true;
+}
+
+void AnalizadorZoom::calculaEspectro(std::vector<float>& espectroDb,
+    std::vector<float>& picosDb,
+    double duracionDelFrame,
+    float negativeInfinity)
+{
+    const auto numBins = getNumBins();
+
+    for (int k = 0; k < numBins; ++k)
+        entradaFFT[size_t(k)] = { historialI[size_t(k)] * ventana[size_t(k)], historialQ[size_t(k)] * ventana[size_t(k)] };
+
+    fft->perform(entradaFFT.data(), salidaFFT.data(), false);
+
+    //reordenamos para que el bin 0 sea la frecuencia mas baja de la banda
+    espectroDb.resize(size_t(numBins));
+    for (int k = 0; k < numBins; ++k)
+    {
+        auto potencia = std::norm(salidaFFT[size_t((k + numBins / 2) % numBins)]);
+        espectroDb[size_t(k)] = std::isfinite(potencia) ? potencia : 0.f;
+    }
+
+    promediador.process(espectroDb.data(), numBins, duracionDelFrame);
+
+    //un seno de amplitud A aparece con A/2 en la seal compleja, (2/N)^2 lo deja al nivel de la traza normal
+    const auto escala = 4.f / (float(numBins) * float(numBins));
+    OperacionesVectoriales::potenciasADecibelios(espectroDb.data(), numBins, escala, negativeInfinity);
+
+    picosDb.clear();
+    if (promediador.retienePicos())
+    {
+        picosDb = promediador.getPicos();
+        OperacionesVectoriales::potenciasADecibelios(picosDb.data(), numBins, escala, negativeInfinity);
+    }
+}
+
+void BancoDeTercios::prepare(double sampleRate)
+{
+    frecuenciaPreparada = sampleRate;
+    numEtapas = 0;
+
+    for (size_t e = 0; e < etapas.size(); ++e)
+    {
+        etapas[e].frecuencia = sampleRate / double(1 << e);
+        etapas[e].bandas.clear();
+    }
+
+    for (int b = numBandas - 1; b >= 0; --b)
+    {
+        auto& banda = bandas[(size_t)b];
+        const auto fInferior = double(getFrecuenciaInferior(b));
+        const auto fSuperior = double(getFrecuenciaSuperior(b));
+
+        //p.ej. la de 20 kHz a 44.1 kHz, su borde alto pasa de Nyquist
+        banda.disponible = fSuperior < 0.48 * sampleRate;
+
+        if (!banda.disponible)
+            continue;
+
+        size_t etapa = 0;
+        while (etapa + 1 < etapas.size() && fSuperior <= limiteDeEtapa * etapas[etapa + 1].frecuencia)
+            ++etapa;
+
+        numEtapas = juce::jmax(numEtapas, (int)etapa + 1);
+        etapas[etapa].bandas.push_back(b);
+
+        const auto coeficientes = disenaBanda(fInferior, fSuperior, etapas[etapa].frecuencia);
+        for (size_t s = 0; s < banda.secciones.size(); ++s)
+            banda.secciones[s].coefficients = coeficientes[s];
+    }
+
+    for (size_t e = 1; e < (size_t)numEtapas; ++e)
+    {
+        //pasa hasta un cuarto de la nueva frecuencia y deja lo que se pliega encima (> 3/4) ~55 dB abajo
+        const auto paso = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(float(etapas[e].frecuencia / 3.0),
+            etapas[e - 1].frecuencia,
+            2 * (int)etapas[e].antialias.size());
+
+        for (size_t s = 0; s < etapas[e].antialias.size(); ++s)
+            etapas[e].antialias[s].coefficients = paso[(int)s];
+    }
+
+    setTiempoDeIntegracion(tiempoDeIntegracionMs);
+    reinicia();
+}
+
+std::array<Coefficients, BancoDeTercios::seccionesPorBanda> BancoDeTercios::disenaBanda(double fInferior,
+    double fSuperior,
+    double sampleRate)
+{
+    using namespace juce;
+
+    //bordes predistorsionados para que la bilineal los deje en su sitio
+    const auto K = 2.0 * sampleRate;
+    const auto w1 = K * std::tan(MathConstants<double>::pi * fInferior / sampleRate);
+    const auto w2 = K * std::tan(MathConstants<double>::pi * fSuperior / sampleRate);
+    const auto w0Cuadrado = w1 * w2;
+    const auto B = w2 - w1;
+
+    /*
+     each lowpass prototype pole p gives the two roots of s^2 - p B s + w0^2. the real pole
+     gives a conjugate pair, one biquad; the complex pair gives two biquads, one per root
+     of the upper pole with its conjugate. every biquad gets B s on top, so the cascade
+     is exactly the prototype at the centre, 0 dB.
+     */
+    const auto polo = std::polar(1.0, 2.0 * MathConstants<double>::pi / 3.0);
+    const auto discriminante = std::sqrt(polo * polo * B * B - 4.0 * w0Cuadrado);
+    const auto discriminanteReal = std::sqrt(std::complex<double>(B * B - 4.0 * w0Cuadrado));
+
+    const std::array<std::complex<double>, seccionesPorBanda> raices{ 0.5 * (polo * B + discriminante),
+        0.5 * (polo * B - discriminante),
+        0.5 * (-B + discriminanteReal) };
+
+    std::array<Coefficients, seccionesPorBanda> secciones;
+
+    for (size_t s = 0; s < raices.size(); ++s)
+    {
+        //H(s) = B s / (s^2 + a1 s + a0), con s = K (1 - z^-1) / (1 + z^-1)
+        const auto a1 = -2.0 * raices[s].real();
+        const auto a0 = std::norm(raices[s]);
+
+        secciones[s] = new dsp::IIR::Coefficients<float>((float)(B * K),
+            0.f,
+            (float)(-B * K),
+            (float)(K * K + a1 * K + a0),
+            (float)(2.0 * (a0 - K * K)),
+            (float)(K * K - a1 * K + a0));
+    }
+
+    return secciones;
+}
+
+void BancoDeTercios::reinicia()
+{
+    for (auto& banda : bandas)
+    {
+        for (auto& seccion : banda.secciones)
+            seccion.reset();
+
+        banda.cuadraticoMedio = 0.f;
+    }
+
+    for (auto& etapa : etapas)
+    {
+        for (auto& seccion : etapa.antialias)
+            seccion.reset();
+
+        etapa.tomaEstaMuestra = false;
+    }
+}
+
+void BancoDeTercios::setTiempoDeIntegracion(float tiempoMs)
+{
+    tiempoDeIntegracionMs = juce::jmax(1.f, tiempoMs);
+
+    //cada etapa integra a su propia frecuencia con la misma constante de tiempo
+    for (auto& etapa : etapas)
+        etapa.coeficienteDetector = (float)(1.0 - std::exp(-1000.0 / (double(tiempoDeIntegracionMs) * etapa.frecuencia)));
+}
+
+void BancoDeTercios::process(const float* muestras, int numMuestras)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    if ((int)bufferEtapa.size() < numMuestras)
+        bufferEtapa.resize((size_t)numMuestras);
+
+    std::copy(muestras, muestras + numMuestras, bufferEtapa.begin());
+
+    auto* x = bufferEtapa.data();
+    auto n = numMuestras;
+
+    for (size_t e = 0; e < (size_t)numEtapas; ++e)
+    {
+        auto& etapa = etapas[e];
+
+        //se diezma sobre el mismo buffer, la muestra que se escribe nunca va por delante de la que se lee
+        if (e > 0)
+        {
+            auto numDiezmadas = 0;
+
+            for (int i = 0; i < n; ++i)
+            {
+                auto y = x[i];
+                for (auto& seccion : etapa.antialias)
+                    y = seccion.processSample(y);
+
+                if (etapa.tomaEstaMuestra)
+                    x[numDiezmadas++] = y;
+
+                etapa.tomaEstaMuestra = !etapa.tomaEstaMuestra;
+            }
+
+            n = numDiezmadas;
+        }
+
+        for (auto b : etapa.bandas)
+        {
+            auto& banda = bandas[(size_t)b];
+            auto cuadraticoMedio = banda.cuadraticoMedio;
+
+            for (int i = 0; i < n; ++i)
+            {
+                auto y = x[i];
+                for (auto& seccion : banda.secciones)
+                    y = seccion.processSample(y);
+
+                cuadraticoMedio += etapa.coeficienteDetector * (y * y - cuadraticoMedio);
+            }
+
+            banda.cuadraticoMedio = cuadraticoMedio;
+        }
+    }
+}
+
+void BancoDeTercios::getPotencias(float* potencias) const
+{
+    for (size_t b = 0; b < bandas.size(); ++b)
+        potencias[b] = bandas[b].disponible ? 2.f * bandas[b].cuadraticoMedio : 0.f;
+}
+
+void ProductorDeOndas::process(juce::Rectangle<float> fftBounds,
+    double sampleRate,
+    const ConfiguracionAnalizador& configuracion)
+{
+    preparaAnalisis(configuracion.modo, sampleRate);
+
+    const auto fraccionDeOctava = getFraccionDeOctava(configuracion.suavizado);
+    generadorDatosFFTCanalIzq.setFraccionDeOctava(fraccionDeOctava);
+
+    for (auto& banda : bandasMultiResolucion)
+        banda.generador.setFraccionDeOctava(fraccionDeOctava);
+
+    generadorDatosFFTCanalIzq.setPromediado(configuracion);
+    analizadorZoom.setPromediado(configuracion);
+    promediadorReasignado.setConfiguracion(configuracion);
+    detectorDePicos.setNumPicos(configuracion.numPicosMarcados);
+
+    //el promedio exponencial lo hace el detector del banco, muestra a muestra; si no, integra como un "Fast"
+    const auto exponencial = configuracion.promediado == ModoPromediado::Promediado_Exponencial;
+    bancoDeTercios.setTiempoDeIntegracion(exponencial ? configuracion.tiempoPromediadoMs : BancoDeTercios::tiempoRapidoMs);
+
+    auto configuracionTercios = configuracion;
+    if (exponencial)
+        configuracionTercios.promediado = ModoPromediado::Promediado_Ninguno;
+
+    promediadorTercios.setConfiguracion(configuracionTercios);
+
+    for (auto& banda : bandasMultiResolucion)
+        banda.generador.setPromediado(configuracion);
+
+    //la traza pre EQ es solo de referencia, sin retencion de picos
+    auto configuracionPre = configuracion;
+    configuracionPre.retenerPicos = false;
+
+    generadorPreEcualizacion.setFraccionDeOctava(fraccionDeOctava);
+    generadorPreEcualizacion.setPromediado(configuracionPre);
+
+    //la referencia igual, asi la diferencia compara dos trazas suavizadas y promediadas igual
+    generadorReferencia.setFraccionDeOctava(fraccionDeOctava);
+    generadorReferencia.setPromediado(configuracionPre);
+
+    const auto eje = getEjeDeFrecuencias(configuracion);
+
+    if (modo == ModoAnalizador::Modo_Zoom
+        && analizadorZoom.necesitaPreparar(frecuenciaDeAnalisis, configuracion.zoomDesde, configuracion.zoomHasta))
+    {
+        analizadorZoom.prepare(frecuenciaDeAnalisis, configuracion.zoomDesde, configuracion.zoomHasta);
+    }
+
+    //peso de cada trama en el promedio de la funcion de transferencia
+    const auto alfaTransferencia = 1.f / float(juce::jmax(1, configuracion.framesPromediados));
+
+    juce::AudioBuffer<float> tempIncomingBuffer;
+    while (canalIzqFIFO->getNumCompleteBuffersAvailable() > 0)
+    {
+        SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>::InfoDelBuffer info;
+
+        if (canalIzqFIFO->getAudioBuffer(tempIncomingBuffer, info))
+        {
+            //la salida no se diezma sola: cada bloque va con el de la entrada del mismo numero
+            if (modo == ModoAnalizador::Modo_Transferencia)
+            {
+                procesaTransferencia(tempIncomingBuffer, info.numero, fftBounds, alfaTransferencia);
+                continue;
+            }
+
+            const auto pico = info.pico;
+            const auto numMuestras = tempIncomingBuffer.getNumSamples();
+            bloqueDiezmado.setSize(1, numMuestras / diezmador.getFactor() + 1, false, false, true);
+
+            const auto numDiezmadas = diezmador.process(tempIncomingBuffer.getReadPointer(0),
+                numMuestras,
+                bloqueDiezmado.getWritePointer(0));
+
+            if (numDiezmadas == 0)
+                continue;
+
+            //el banco de filtros no necesita historial ni se salta el silencio, sus detectores tienen que caer
+            if (modo == ModoAnalizador::Modo_Tercios)
+            {
+                procesaTercios(bloqueDiezmado.getReadPointer(0), numDiezmadas);
+                continue;
+            }
+
+            aadeAlHistorial(monoBuffer, bloqueDiezmado.getReadPointer(0), numDiezmadas);
+
+            /*
+             la ventana solo es silencio cuando todo lo que contiene, mas la cola del
+             filtro de diezmado, vino de bloques por debajo del umbral.
+             */
+            muestrasEnSilencio = pico < umbralDeSilencio ? juce::jmin(muestrasEnSilencio + numDiezmadas, 1 << 30) : 0;
+            const bool silencioso = muestrasEnSilencio >= monoBuffer.getNumSamples() + diezmador.getMuestrasDeMemoria();
+
+            if (!silencioso)
+                limitesDelSuelo = {};
+
+            if (modo == ModoAnalizador::Modo_MultiResolucion)
+            {
+                procesaMultiResolucion(numDiezmadas, fftBounds, silencioso);
+            }
+            else if (modo == ModoAnalizador::Modo_Reasignado)
+            {
+                procesaReasignado(numDiezmadas, fftBounds, silencioso);
+            }
+            else if (modo == ModoAnalizador::Modo_Zoom)
+            {
+                if (analizadorZoom.process(bloqueDiezmado.getReadPointer(0), numDiezmadas, espectroZoom, picosZoom, -48.f))
+                {
+                    productorDeSeal.generatePath(espectroZoom,
+                        analizadorZoom.getNumBins(),
+                        fftBounds,
+                        analizadorZoom.getAnchoDeBin(),
+                        -48.f,
+                        eje,
+                        analizadorZoom.getFrecuenciaPrimerBin());
+
+                    publicaPicos(espectroZoom.data(),
+                        analizadorZoom.getNumBins(),
+                        analizadorZoom.getAnchoDeBin(),
+                        analizadorZoom.getFrecuenciaPrimerBin(),
+                        configuracion.zoomDesde,
+                        configuracion.zoomHasta);
+
+                    if (!picosZoom.empty())
+                    {
+                        productorDePicos.generatePath(picosZoom,
+                            analizadorZoom.getNumBins(),
+                            fftBounds,
+                            analizadorZoom.getAnchoDeBin(),
+                            -48.f,
+                            eje,
+                            analizadorZoom.getFrecuenciaPrimerBin());
+                    }
+                }
+            }
+            else
+            {
+                const auto dt = double(numDiezmadas) / frecuenciaDeAnalisis;
+
+                if (!silencioso)
+                    generadorDatosFFTCanalIzq.produceFFTDataForRendering(monoBuffer, -48.f, dt);
+                else if (!generadorDatosFFTCanalIzq.produceTramaSilenciosa(-48.f, dt))
+                    publicaSuelo(fftBounds);
+            }
+        }
+    }
+
+    const auto fftSize = generadorDatosFFTCanalIzq.getFFTSize();
+    const auto binWidth = frecuenciaDeAnalisis / double(fftSize);
+
+    std::vector<float> datoFFT;
+    while (generadorDatosFFTCanalIzq.getNumAvailableFFTDataBlocks() > 0)
+    {
+        if (generadorDatosFFTCanalIzq.getFFTData(datoFFT))
+        {
+            productorDeSeal.generatePath(datoFFT, fftBounds, fftSize, binWidth, -48.f);
+        }
+    }
+
+    //basta con marcar los picos de la ultima trama
+    if (!datoFFT.empty())
+        publicaPicos(datoFFT.data(), fftSize / 2, float(binWidth), 0.f, 20.f, 20000.f);
+
+    //solo hace falta la traza de picos mas reciente
+    std::vector<float> datoPicos;
+    while (generadorDatosFFTCanalIzq.getNumAvailablePeakBlocks() > 0)
+        generadorDatosFFTCanalIzq.getPeakData(datoPicos);
+
+    if (!datoPicos.empty())
+        productorDePicos.generatePath(datoPicos, fftBounds, fftSize, binWidth, -48.f);
+
+    if (configuracion.mostrarPreEcualizacion && modo == ModoAnalizador::Modo_Normal)
+    {
+        procesaTrazaAdicional(*canalPreFIFO, diezmadorPre, historialPre, muestrasEnSilencioPre, generadorPreEcualizacion);
+
+        //la traza pre EQ es solo de referencia, basta con la trama mas reciente
+        std::vector<float> datoPre;
+        while (generadorPreEcualizacion.getNumAvailableFFTDataBlocks() > 0)
+            generadorPreEcualizacion.getFFTData(datoPre);
+
+        if (!datoPre.empty())
+            productorPreEcualizacion.generatePath(datoPre, fftBounds, fftSize, binWidth, -48.f);
+    }
+    else if (modo != ModoAnalizador::Modo_Transferencia)
+    {
+        juce::AudioBuffer<float> descartado;
+        while (canalPreFIFO->getAudioBuffer(descartado)) { }
+    }
+
+    if (configuracion.vistaReferencia != VistaReferencia::Referencia_Apagada && modo == ModoAnalizador::Modo_Normal)
+    {
+        procesaReferencia(datoFFT, fftBounds, configuracion.vistaReferencia == VistaReferencia::Referencia_ConDiferencia);
+    }
+    else
+    {
+        juce::AudioBuffer<float> descartado;
+        while (canalReferenciaFIFO->getAudioBuffer(descartado)) { }
+    }
+}
+
+void ProductorDeOndas::procesaTrazaAdicional(SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>& canal,
+    DiezmadorPolifasico& diezmadorDeLaTraza,
+    juce::AudioBuffer<float>& historial,
+    int& muestrasEnSilencioDeLaTraza,
+    GeneradorDeDatosFFT<std::vector<float>>& generador)
+{
+    juce::AudioBuffer<float> bloque;
+    float pico = 1.f;
+
+    while (canal.getAudioBuffer(bloque, pico))
+    {
+        const auto numMuestras = bloque.getNumSamples();
+        bloqueDiezmado.setSize(1, numMuestras / diezmadorDeLaTraza.getFactor() + 1, false, false, true);
+
+        const auto numDiezmadas = diezmadorDeLaTraza.process(bloque.getReadPointer(0),
+            numMuestras,
+            bloqueDiezmado.getWritePointer(0));
+
+        if (numDiezmadas == 0)
+            continue;
+
+        aadeAlHistorial(historial, bloqueDiezmado.getReadPointer(0), numDiezmadas);
+
+        //el mismo criterio de silencio que la traza principal
+        muestrasEnSilencioDeLaTraza = pico < umbralDeSilencio ? juce::jmin(muestrasEnSilencioDeLaTraza + numDiezmadas, 1 << 30) : 0;
+        const bool silencioso = muestrasEnSilencioDeLaTraza >= historial.getNumSamples() + diezmadorDeLaTraza.getMuestrasDeMemoria();
+
+        const auto dt = double(numDiezmadas) / frecuenciaDeAnalisis;
+
+        if (!silencioso)
+            generador.produceFFTDataForRendering(historial.getReadPointer(0) + historial.getNumSamples()
+                - generador.getFFTSize(), -48.f, dt);
+        else
+            generador.produceTramaSilenciosa(-48.f, dt);
+    }
+}
+
+void ProductorDeOndas::procesaReferencia(const std::vector<float>& datoSalida, juce::Rectangle<float> fftBounds, bool conDiferencia)
+{
+    //un hueco en la referencia solo vuelve a empezar su propio historial, la salida sigue
+    const auto generacion = canalReferenciaFIFO->getGeneracion();
+
+    if (generacion != generacionReferenciaLeida)
+    {
+        generacionReferenciaLeida = generacion;
+        reiniciaReferencia();
+        return;
+    }
+
+    procesaTrazaAdicional(*canalReferenciaFIFO, diezmadorReferencia, historialReferencia, muestrasEnSilencioReferencia, generadorReferencia);
+
+    const auto fftSize = generadorReferencia.getFFTSize();
+    const auto numBins = fftSize / 2;
+    const auto binWidth = frecuenciaDeAnalisis / double(fftSize);
+
+    auto hayReferenciaNueva = false;
+    while (generadorReferencia.getNumAvailableFFTDataBlocks() > 0)
+        hayReferenciaNueva = generadorReferencia.getFFTData(datoReferencia) || hayReferenciaNueva;
+
+    if (hayReferenciaNueva)
+        productorReferencia.generatePath(datoReferencia, fftBounds, fftSize, binWidth, -48.f);
+
+    //la salida en silencio no publica tramas, la diferencia usa la ultima que llego
+    if (!datoSalida.empty())
+        ultimaSalida = datoSalida;
+
+    if (!conDiferencia || (!hayReferenciaNueva && datoSalida.empty()))
+        return;
+
+    //una trama de antes de cambiar el tamao de la FFT no se compara con las de ahora
+    if (ultimaSalida.size() != datoReferencia.size() || datoReferencia.size() < (size_t)numBins)
+        return;
+
+    //se dibuja en la escala de la curva del EQ, +-24 dB: 24 dB por debajo cae en la de -48 a 0 de las trazas
+    diferencia.resize((size_t)numBins);
+
+    for (int k = 0; k < numBins; ++k)
+        diferencia[(size_t)k] = juce::jlimit(-48.f, 0.f, ultimaSalida[(size_t)k] - datoReferencia[(size_t)k] - 24.f);
+
+    productorDiferencia.generatePath(diferencia, fftBounds, fftSize, binWidth, -48.f);
+}
+
+void ProductorDeOndas::reiniciaReferencia()
+{
+    juce::AudioBuffer<float> descartado;
+    while (canalReferenciaFIFO->getAudioBuffer(descartado)) { }
+
+    historialReferencia.clear();
+    diezmadorReferencia.reinicia();
+    muestrasEnSilencioReferencia = 0;
+
+    //preparaAnalisis() pasa por aqui, asi no queda ninguna trama con el tamao anterior
+    datoReferencia.clear();
+    ultimaSalida.clear();
+}
+
+void ProductorDeOndas::setParametrosDeRender(juce::Rectangle<float> fftBounds,
+    double sampleRate,
+    const ConfiguracionAnalizador& configuracion)
+{
+    const juce::SpinLock::ScopedLockType sl(lockParametros);
+    limitesFFT = fftBounds;
+    frecuenciaMuestreo = sampleRate;
+    configuracionAnalizador = configuracion;
+}
+
+void ProductorDeOndas::recogeSeal()
+{
+    while (productorDeSeal.getNumPathsAvailable() > 0)
+    {
+        productorDeSeal.getPath(sealFFTCanalIzq);
+    }
+
+    while (productorDePicos.getNumPathsAvailable() > 0)
+    {
+        productorDePicos.getPath(sealPicos);
+    }
+
+    while (productorPreEcualizacion.getNumPathsAvailable() > 0)
+    {
+        productorPreEcualizacion.getPath(sealPreEcualizacion);
+    }
+
+    while (productorReferencia.getNumPathsAvailable() > 0)
+    {
+        productorReferencia.getPath(sealReferencia);
+    }
+
+    while (productorDiferencia.getNumPathsAvailable() > 0)
+    {
+        productorDiferencia.getPath(sealDiferencia);
+    }
+
+    while (picosFifo.getNumAvailableForReading() > 0)
+    {
+        picosFifo.pull(picosParaDibujar);
+    }
+
+    while (transferenciaFifo.getNumAvailableForReading() > 0)
+    {
+        transferenciaFifo.pull(transferenciaParaDibujar);
+    }
+
+    while (terciosFifo.getNumAvailableForReading() > 0)
+    {
+        terciosFifo.pull(terciosParaDibujar);
+    }
+}
+
+void ProductorDeOndas::procesaReasignado(int muestrasNuevas, juce::Rectangle<float> fftBounds, bool silencioso)
+{
+    const auto width = (int)fftBounds.getWidth();
+    const auto fftSize = espectroReasignado.getFFTSize();
+
+    if (width <= 0 || fftSize == 0)
+        return;
+
+    if (silencioso)
+    {
+        if (reasignadoEnSuelo)
+        {
+            publicaSuelo(fftBounds);
+            return;
+        }
+
+        //sin seal no hay nada que reasignar, solo dejamos caer el promedio
+        columnasReasignadas.assign((size_t)width, 0.f);
+    }
+    else
+    {
+        reasignadoEnSuelo = false;
+
+        espectroReasignado.process(monoBuffer.getReadPointer(0) + monoBuffer.getNumSamples() - fftSize);
+
+        mapaReasignado.esparceAColumnas(espectroReasignado.getPotencias(),
+            espectroReasignado.getBinesReasignados(),
+            width,
+            espectroReasignado.getNumBins(),
+            float(frecuenciaDeAnalisis / double(fftSize)),
+            columnasReasignadas);
+    }
+
+    promediadorReasignado.process(columnasReasignadas.data(), width, double(muestrasNuevas) / frecuenciaDeAnalisis);
+
+    //las potencias ya vienen normalizadas, un seno a fondo de escala suma 1 en su columna
+    OperacionesVectoriales::potenciasADecibelios(columnasReasignadas.data(), width, 1.f, -48.f);
+    productorDeSeal.generatePathDesdeColumnas(columnasReasignadas, fftBounds, -48.f);
+
+    if (promediadorReasignado.retienePicos())
+    {
+        picosReasignados = promediadorReasignado.getPicos();
+        OperacionesVectoriales::potenciasADecibelios(picosReasignados.data(), width, 1.f, -48.f);
+        productorDePicos.generatePathDesdeColumnas(picosReasignados, fftBounds, -48.f);
+    }
+
+    //las columnas no estan equiespaciadas en frecuencia, aqui no marcamos picos
+    picosFifo.push({});
+
+    if (silencioso)
+    {
+        reasignadoEnSuelo = juce::FloatVectorOperations::findMaximum(columnasReasignadas.data(), width) <= -48.f
+            && (!promediadorReasignado.retienePicos()
+                || juce::FloatVectorOperations::findMaximum(picosReasignados.data(), width) <= -48.f);
+    }
+}
+
+void ProductorDeOndas::publicaSuelo(juce::Rectangle<float> fftBounds)
+{
+    //la traza ya esta en el suelo, solo hay que rehacerla si cambia la zona de dibujo
+    if (fftBounds == limitesDelSuelo)
+        return;
+
+    limitesDelSuelo = fftBounds;
+    sueloPorColumna.assign((size_t)fftBounds.getWidth(), -48.f);
+
+    productorDeSeal.generatePathDesdeColumnas(sueloPorColumna, fftBounds, -48.f);
+    productorDePicos.generatePathDesdeColumnas(sueloPorColumna, fftBounds, -48.f);
+    picosFifo.push({});
+}
+
+void ProductorDeOndas::descartaPendientes()
+{
+    juce::AudioBuffer<float> descartado;
+    while (canalIzqFIFO->getAudioBuffer(descartado)) { }
+    while (canalPreFIFO->getAudioBuffer(descartado)) { }
+    while (canalReferenciaFIFO->getAudioBuffer(descartado)) { }
+
+    hayBloqueEntrada = false;
+}
+
+void ProductorDeOndas::reiniciaHistorial()
+{
+    //sin esto la primera FFT mezclaria audio de antes y de despues del hueco
+    monoBuffer.clear();
+    historialPre.clear();
+
+    //los dos diezmadores empiezan a la vez para que entrada y salida sigan alineadas
+    diezmador.reinicia();
+    diezmadorPre.reinicia();
+
+    for (auto& banda : bandasMultiResolucion)
+        banda.muestrasPendientes = 0;
+
+    muestrasEnSilencio = 0;
+    muestrasEnSilencioPre = 0;
+
+    funcionDeTransferencia.reinicia();
+    muestrasPendientesTransferencia = 0;
+    hayBloqueEntrada = false;
+
+    bancoDeTercios.reinicia();
+    muestrasPendientesTercios = 0;
+}
+
+void ProductorDeOndas::publicaPicos(const float* datosDb,
+    int numBins,
+    float binWidth,
+    float frecuenciaPrimerBin,
+    float desde,
+    float hasta)
+{
+    PicosEspectrales picos;
+    detectorDePicos.busca(datosDb, numBins, binWidth, frecuenciaPrimerBin, desde, hasta, picos);
+    picosFifo.push(picos);
+}
+
+void ProductorDeOndas::procesaTransferencia(const juce::AudioBuffer<float>& salida,
+    int numeroDelBuffer,
+    juce::Rectangle<float> fftBounds,
+    float alfa)
+{
+    //sin su pareja el bloque se pierde en las dos seales, asi siguen alineadas
+    if (!buscaEntradaDeTransferencia(numeroDelBuffer))
+        return;
+
+    hayBloqueEntrada = false;
+
+    const auto numMuestras = salida.getNumSamples();
+    bloqueDiezmado.setSize(1, numMuestras / diezmador.getFactor() + 1, false, false, true);
+    bloqueEntradaDiezmado.setSize(1, numMuestras / diezmadorPre.getFactor() + 1, false, false, true);
+
+    const auto numDiezmadas = diezmador.process(salida.getReadPointer(0), numMuestras, bloqueDiezmado.getWritePointer(0));
+    const auto numEntrada = diezmadorPre.process(bloqueEntrada.getReadPointer(0), numMuestras, bloqueEntradaDiezmado.getWritePointer(0));
+
+    //los dos diezmadores se reinician juntos y reciben lo mismo, siempre dan las mismas muestras
+    jassert(numDiezmadas == numEntrada);
+    juce::ignoreUnused(numEntrada);
+
+    if (numDiezmadas == 0)
+        return;
+
+    aadeAlHistorial(monoBuffer, bloqueDiezmado.getReadPointer(0), numDiezmadas);
+    aadeAlHistorial(historialPre, bloqueEntradaDiezmado.getReadPointer(0), numDiezmadas);
+
+    muestrasEnSilencioPre = infoBloqueEntrada.pico < umbralDeSilencio
+        ? juce::jmin(muestrasEnSilencioPre + numDiezmadas, 1 << 30)
+        : 0;
+
+    const auto fftSize = funcionDeTransferencia.getFFTSize();
+    const auto salto = fftSize / 2;
+
+    muestrasPendientesTransferencia += numDiezmadas;
+
+    if (muestrasPendientesTransferencia < salto)
+        return;
+
+    muestrasPendientesTransferencia %= salto;
+
+    //sin excitacion en la entrada la trama no dice nada de la cadena, no entra en el promedio
+    if (muestrasEnSilencioPre >= fftSize)
+        return;
+
+    funcionDeTransferencia.process(historialPre.getReadPointer(0) + historialPre.getNumSamples() - fftSize,
+        monoBuffer.getReadPointer(0) + monoBuffer.getNumSamples() - fftSize,
+        alfa);
+
+    publicaTransferencia(fftBounds);
+}
+
+bool ProductorDeOndas::buscaEntradaDeTransferencia(int numeroDelBuffer)
+{
+    //la entrada se llena antes que la salida en cada processBlock, su pareja ya tiene que estar en el fifo
+    while (!hayBloqueEntrada || infoBloqueEntrada.numero < numeroDelBuffer)
+    {
+        hayBloqueEntrada = canalPreFIFO->getAudioBuffer(bloqueEntrada, infoBloqueEntrada);
+
+        if (!hayBloqueEntrada)
+            return false;
+    }
+
+    //si la entrada va por delante, la guardamos para el siguiente bloque de salida
+    return infoBloqueEntrada.numero == numeroDelBuffer;
+}
+
+void ProductorDeOndas::publicaTransferencia(juce::Rectangle<float> fftBounds)
+{
+    const auto width = (int)fftBounds.getWidth();
+    const auto numBins = funcionDeTransferencia.getNumBins();
+    const auto binWidth = float(frecuenciaDeAnalisis / double(funcionDeTransferencia.getFFTSize()));
+
+    if (width <= 0)
+        return;
+
+    mapaTransferencia.sumaAColumnas(funcionDeTransferencia.getGxx(), width, numBins, binWidth, columnasGxx);
+    mapaTransferencia.sumaAColumnas(funcionDeTransferencia.getGyy(), width, numBins, binWidth, columnasGyy);
+    mapaTransferencia.sumaAColumnas(funcionDeTransferencia.getGxyRe(), width, numBins, binWidth, columnasGxyRe);
+    mapaTransferencia.sumaAColumnas(funcionDeTransferencia.getGxyIm(), width, numBins, binWidth, columnasGxyIm);
+
+    medidaTransferencia.magnitudDb.resize((size_t)width);
+    medidaTransferencia.faseGrados.resize((size_t)width);
+    medidaTransferencia.coherencia.resize((size_t)width);
+
+    for (size_t x = 0; x < (size_t)width; ++x)
+    {
+        const auto gxx = columnasGxx[x];
+        const auto gyy = columnasGyy[x];
+        const auto cruzado = std::hypot(columnasGxyRe[x], columnasGxyIm[x]);
+
+        //H1 = Gxy / Gxx, las columnas sin energia de entrada se quedan abajo del todo
+        medidaTransferencia.magnitudDb[x] = gxx > 0.f && cruzado > 0.f
+            ? juce::Decibels::gainToDecibels(cruzado / gxx, -100.f)
+            : -100.f;
+
+        medidaTransferencia.faseGrados[x] = juce::radiansToDegrees(std::atan2(columnasGxyIm[x], columnasGxyRe[x]));
+
+        medidaTransferencia.coherencia[x] = gxx > 0.f && gyy > 0.f
+            ? juce::jlimit(0.f, 1.f, cruzado * cruzado / (gxx * gyy))
+            : 0.f;
+    }
+
+    transferenciaFifo.push(medidaTransferencia);
+}
+void ProductorDeOndas::procesaTercios(const float* muestras, int numMuestras)
+{
+    bancoDeTercios.process(muestras, numMuestras);
+
+    muestrasPendientesTercios += numMuestras;
+
+    const auto salto = juce::jmax(1, int(frecuenciaDeAnalisis / double(tramasDeTerciosPorSegundo)));
+    if (muestrasPendientesTercios < salto)
+        return;
+
+    const auto duracionDelFrame = double(muestrasPendientesTercios) / frecuenciaDeAnalisis;
+    muestrasPendientesTercios = 0;
+
+    const auto numBandas = NivelesDeTercios::numBandas;
+
+    bancoDeTercios.getPotencias(potenciasTercios.data());
+    promediadorTercios.process(potenciasTercios.data(), numBandas, duracionDelFrame);
+
+    std::copy(potenciasTercios.begin(), potenciasTercios.end(), nivelesDeTercios.nivelesDb.begin());
+    OperacionesVectoriales::potenciasADecibelios(nivelesDeTercios.nivelesDb.data(), numBandas, 1.f, -48.f);
+
+    nivelesDeTercios.conPicos = promediadorTercios.retienePicos();
+    if (nivelesDeTercios.conPicos)
+    {
+        std::copy(promediadorTercios.getPicos().begin(), promediadorTercios.getPicos().end(), nivelesDeTercios.picosDb.begin());
+        OperacionesVectoriales::potenciasADecibelios(nivelesDeTercios.picosDb.data(), numBandas, 1.f, -48.f);
+    }
+
+    for (int b = 0; b < numBandas; ++b)
+        nivelesDeTercios.disponibles[(size_t)b] = bancoDeTercios.estaDisponible(b);
+
+    terciosFifo.push(nivelesDeTercios);
+}
+
+bool ProductorDeOndas::hayTrabajoPendiente()
+{
+    return activo.load()
+        && (canalIzqFIFO->getNumCompleteBuffersAvailable() > 0
+            || canalPreFIFO->getNumCompleteBuffersAvailable() > 0
+            || canalReferenciaFIFO->getNumCompleteBuffersAvailable() > 0);
+}
+
+void ProductorDeOndas::ejecuta()
+{
+    juce::Rectangle<float> fftBounds;
+    double sampleRate;
+    ConfiguracionAnalizador configuracion;
+
+    {
+        const juce::SpinLock::ScopedLockType sl(lockParametros);
+        fftBounds = limitesFFT;
+        sampleRate = frecuenciaMuestreo;
+        configuracion = configuracionAnalizador;
+    }
+
+    if (fftBounds.isEmpty() || sampleRate <= 0.0)
+    {
+        //sin zona de dibujo no hay nada que analizar, descartamos lo recibido
+        descartaPendientes();
+        return;
+    }
+
+    //el audio dejo de llenar los fifos y ha vuelto: lo que queda en cola es de antes del hueco
+    auto generacion = canalIzqFIFO->getGeneracion();
+    auto generacionPre = canalPreFIFO->getGeneracion();
+
+    if (generacion != generacionLeida || generacionPre != generacionPreLeida)
+    {
+        generacionLeida = generacion;
+        generacionPreLeida = generacionPre;
+        descartaPendientes();
+        reiniciaHistorial();
+        return;
+    }
+
+    process(fftBounds, sampleRate, configuracion);
+}
+
+void MedidaEnSegundoPlano::empieza()
+{
+    alEmpezar();
+    activo.store(true);
+    ++peticion;
+}
+
+void MedidaEnSegundoPlano::cancela()
+{
+    activo.store(false);
+    ++peticion;
+
+    alCancelar();
+}
+
+void MedidaEnSegundoPlano::setParametrosDeRender(juce::Rectangle<float> fftBounds, const EjeDeFrecuencias& eje)
+{
+    const juce::SpinLock::ScopedLockType sl(lockParametros);
+
+    if (fftBounds == limitesFFT && eje == ejeDeDibujo)
+        return;
+
+    limitesFFT = fftBounds;
+    ejeDeDibujo = eje;
+    redibujar.store(true);
+}
+
+void MedidaEnSegundoPlano::getParametrosDeRender(juce::Rectangle<float>& fftBounds, EjeDeFrecuencias& eje)
+{
+    const juce::SpinLock::ScopedLockType sl(lockParametros);
+    fftBounds = limitesFFT;
+    eje = ejeDeDibujo;
+}
+
+bool MedidaEnSegundoPlano::hayTrabajoPendiente()
+{
+    if (peticion.load() != peticionAtendida)
+        return true;
+
+    if (!activo.load())
+        return false;
+
+    switch (fase)
+    {
+    case Fase::Copiando: return hayAlgoQueCopiar();
+    case Fase::Procesando: return true;
+    case Fase::Terminado: return redibujar.load();
+    }
+
+    return false;
+}
+
+void MedidaEnSegundoPlano::ejecuta()
+{
+    const auto peticionActual = peticion.load();
+
+    if (peticionActual != peticionAtendida)
+    {
+        peticionAtendida = peticionActual;
+        fase = Fase::Copiando;
+        hayResultado = false;
+    }
+
+    if (!activo.load())
+    {
+        fase = Fase::Terminado;
+        return;
+    }
+
+    switch (fase)
+    {
+    case Fase::Copiando:
+        switch (intentaCopiar())
+        {
+        case Copia::Esperando: break;
+        case Copia::SinDatos: fase = Fase::Terminado; break;
+        case Copia::Copiada: fase = Fase::Procesando; break;
+        }
+        break;
+
+    case Fase::Procesando:
+        if (!avanza())
+            break;
+
+        fase = Fase::Terminado;
+        hayResultado = true;
+        redibujar.store(false);
+        publica();
+        break;
+
+    case Fase::Terminado:
+        if (redibujar.exchange(false) && hayResultado)
+            publica();
+        break;
+    }
+}
+
+void ReanalisisCongelado::alEmpezar()
+{
+    progreso.store(0.f);
+    segundosAnalizados.store(0.0);
+}
+
+void ReanalisisCongelado::alCancelar()
+{
+    for (auto& seal : seales)
+        seal.clear();
+}
+
+void ReanalisisCongelado::recogeSeal()
+{
+    for (size_t canal = 0; canal < productores.size(); ++canal)
+    {
+        while (productores[canal].getNumPathsAvailable() > 0)
+            productores[canal].getPath(seales[canal]);
+    }
+
+    //lo que llegue tarde de un analisis ya cancelado no se dibuja
+    if (!estaActivo())
+    {
+        for (auto& seal : seales)
+            seal.clear();
+    }
+}
+
+MedidaEnSegundoPlano::Copia ReanalisisCongelado::intentaCopiar()
+{
+    if (!captura.copia(muestras, frecuenciaCapturada))
+        return Copia::Esperando;
+
+    if (!preparaAnalisis())
+    {
+        //ni una trama entera capturada: no hay nada que ensear
+        progreso.store(1.f);
+        return Copia::SinDatos;
+    }
+
+    return Copia::Copiada;
+}
+
+bool ReanalisisCongelado::preparaAnalisis()
+{
+    const auto numMuestras = muestras.getNumSamples();
+
+    //con poca captura bajamos el tamao hasta que quepa al menos una trama
+    auto orden = (int)ordenFFT;
+    while (orden > FFTOrder::order2048 && (1 << orden) > numMuestras)
+        --orden;
+
+    const auto fftSize = 1 << orden;
+
+    if (fftSize > numMuestras || frecuenciaCapturada <= 0.0)
+    {
+        segundosAnalizados.store(0.0);
+        return false;
+    }
+
+    if (motor == nullptr || motor->getOrden() != orden)
+    {
+        motor = creaMotorFFT(orden);
+        ventana = std::make_unique<juce::dsp::WindowingFunction<float>>(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+    }
+
+    datos.assign((size_t)fftSize * 2, 0.f);
+
+    for (auto& espectro : espectros)
+        espectro.assign((size_t)fftSize / 2, 0.f);
+
+    framesHechos = 0;
+    numFrames = 1 + (numMuestras - fftSize) / (fftSize / 4);
+
+    segundosAnalizados.store(double(numMuestras) / frecuenciaCapturada);
+    return true;
+}
+
+bool ReanalisisCongelado::avanza()
+{
+    const auto fftSize = motor->getSize();
+    const auto numBins = fftSize / 2;
+    const auto salto = fftSize / 4;
+    const auto numCanales = juce::jmin(muestras.getNumChannels(), (int)espectros.size());
+
+    //las tramas se alinean con el final, lo mas reciente es lo que interesa
+    const auto primerInicio = muestras.getNumSamples() - fftSize - (numFrames - 1) * salto;
+
+    for (int n = 0; n < framesPorLlamada && framesHechos < numFrames; ++n, ++framesHechos)
+    {
+        const auto inicio = primerInicio + framesHechos * salto;
+
+        for (int canal = 0; canal < numCanales; ++canal)
+        {
+            auto* lectura = muestras.getReadPointer(canal, inicio);
+
+            std::copy(lectura, lectura + fftSize, datos.begin());
+            std::fill(datos.begin() + fftSize, datos.end(), 0.f);
+
+            ventana->multiplyWithWindowingTable(datos.data(), (size_t)fftSize);
+            motor->transformadaSoloPotencia(datos.data());
+
+            juce::FloatVectorOperations::add(espectros[(size_t)canal].data(), datos.data(), numBins);
+        }
+    }
+
+    progreso.store(float(framesHechos) / float(numFrames));
+
+    if (framesHechos < numFrames)
+        return false;
+
+    //media de Welch y la misma escala que la traza en vivo, (1 / numBins)^2 en potencia
+    const auto escala = 1.f / (float(numFrames) * float(numBins) * float(numBins));
+
+    for (int canal = 0; canal < numCanales; ++canal)
+        OperacionesVectoriales::potenciasADecibelios(espectros[(size_t)canal].data(), numBins, escala, -48.f);
+
+    return true;
+}
+
+void ReanalisisCongelado::publica()
+{
+    juce::Rectangle<float> fftBounds;
+    EjeDeFrecuencias eje;
+    getParametrosDeRender(fftBounds, eje);
+
+    if (fftBounds.isEmpty())
+        return;
+
+    const auto numBins = motor->getSize() / 2;
+    const auto binWidth = float(frecuenciaCapturada / double(motor->getSize()));
+    const auto numCanales = juce::jmin(muestras.getNumChannels(), (int)espectros.size());
+
+    for (int canal = 0; canal < numCanales; ++canal)
+        productores[(size_t)canal].generatePath(espectros[(size_t)canal], numBins, fftBounds, binWidth, -48.f, eje, 0.f);
+}
+
+void MedidaConBarrido::alCancelar()
+{
+    deconvolucionando.store(false);
+    medidaParaDibujar = {};
+}
+
+void MedidaConBarrido::recogeSeal()
+{
+    while (medidaFifo.getNumAvailableForReading() > 0)
+        medidaFifo.pull(medidaParaDibujar);
+
+    //lo que llegue tarde de una medida ya cancelada no se dibuja
+    if (!estaActivo())
+        medidaParaDibujar = {};
+}
+
+MedidaEnSegundoPlano::Copia MedidaConBarrido::intentaCopiar()
+{
+    if (!barrido.copia(grabacion, frecuenciaGrabada))
+        return Copia::Esperando;
+
+    //el filtro inverso ya son dos FFT de 2^18, los canales van en las llamadas siguientes
+    deconvolucion.prepare(grabacion.getReadPointer(grabacion.getNumChannels() - 1), frecuenciaGrabada);
+
+    canalesHechos = 0;
+    deconvolucionando.store(true);
+    return Copia::Copiada;
+}
+
+bool MedidaConBarrido::avanza()
+{
+    const auto longitud = DeconvolucionDeBarrido::longitudImpulso;
+    const auto numCanales = juce::jmin(grabacion.getNumChannels() - 1, (int)impulsos.size());
+    const auto canal = (size_t)canalesHechos;
+
+    deconvolucion.process(grabacion.getReadPointer(canalesHechos), impulsos[canal]);
+
+    //el modulo sale del impulso ya enventanado, sin la distorsion ni el ruido de despues
+    if (motor == nullptr)
+        motor = creaMotorFFT(DeconvolucionDeBarrido::ordenImpulso);
+
+    datos.assign((size_t)longitud * 2, 0.f);
+    std::copy(impulsos[canal].begin(), impulsos[canal].end(), datos.begin());
+
+    motor->transformadaSoloPotencia(datos.data());
+    potencias[canal].assign(datos.begin(), datos.begin() + longitud / 2);
+
+    if (++canalesHechos < numCanales)
+        return false;
+
+    deconvolucionando.store(false);
+    return true;
+}
+
+void MedidaConBarrido::publica()
+{
+    juce::Rectangle<float> fftBounds;
+    EjeDeFrecuencias eje;
+    getParametrosDeRender(fftBounds, eje);
+
+    const auto width = (int)fftBounds.getWidth();
+
+    if (width <= 0)
+        return;
+
+    const auto longitud = DeconvolucionDeBarrido::longitudImpulso;
+    const auto numBins = longitud / 2;
+    const auto binWidth = float(frecuenciaGrabada / double(longitud));
+    const auto numCanales = juce::jmin(grabacion.getNumChannels() - 1, (int)impulsos.size());
+
+    //cuantos bins caen en cada columna, para pasar de suma a media de potencia
+    unos.assign((size_t)numBins, 1.f);
+    mapa.sumaAColumnas(unos, width, numBins, binWidth, columnasCuenta, eje);
+
+    for (int canal = 0; canal < (int)medida.respuestaDb.size(); ++canal)
+    {
+        auto& respuesta = medida.respuestaDb[(size_t)canal];
+
+        if (canal >= numCanales)
+        {
+            respuesta.clear();
+            continue;
+        }
+
+        mapa.sumaAColumnas(potencias[(size_t)canal], width, numBins, binWidth, columnasPotencia, eje);
+
+        respuesta.resize((size_t)width);
+        for (size_t x = 0; x < (size_t)width; ++x)
+            respuesta[x] = 10.f * std::log10(juce::jmax(columnasPotencia[x] / columnasCuenta[x], 1.0e-10f));
+    }
+
+    const auto frecuenciaFinal = BarridoSinusoidal::getFrecuenciaFinal(frecuenciaGrabada);
+
+    medida.primeraColumna = width;
+    medida.ultimaColumna = -1;
+
+    for (int x = 0; x < width; ++x)
+    {
+        const auto f = eje.aFrecuencia(float(x) / float(width));
+
+        if (f >= BarridoSinusoidal::frecuenciaInicial && f <= frecuenciaFinal)
+        {
+            medida.primeraColumna = juce::jmin(medida.primeraColumna, x);
+            medida.ultimaColumna = x;
+        }
+    }
+
+    //el impulso del canal izquierdo alrededor de su pico, en un recuadro de un tercio del ancho
+    const auto& impulso = impulsos[(size_t)juce::jmin((int)Channel::Left, numCanales - 1)];
+
+    auto pico = 0;
+    for (int n = 1; n < longitud; ++n)
+        if (std::abs(impulso[(size_t)n]) > std::abs(impulso[(size_t)pico]))
+            pico = n;
+
+    const auto muestrasPorMs = frecuenciaGrabada / 1000.0;
+    const auto inicio = juce::jmax(0, pico - (int)std::ceil(msAntesDelPico * muestrasPorMs));
+    const auto fin = juce::jmin(longitud, pico + (int)std::ceil(msDespuesDelPico * muestrasPorMs));
+
+    const auto columnas = juce::jmax(1, width / 3);
+    const auto normalizacion = std::abs(impulso[(size_t)pico]) > 0.f ? 1.f / std::abs(impulso[(size_t)pico]) : 0.f;
+
+    medida.impulsoMinimos.resize((size_t)columnas);
+    medida.impulsoMaximos.resize((size_t)columnas);
+
+    for (int x = 0; x < columnas; ++x)
+    {
+        const auto desde = inicio + (fin - inicio) * x / columnas;
+        const auto hasta = juce::jmax(desde + 1, inicio + (fin - inicio) * (x + 1) / columnas);
+
+        auto rango = juce::FloatVectorOperations::findMinAndMax(impulso.data() + desde, hasta - desde);
+
+        medida.impulsoMinimos[(size_t)x] = rango.getStart() * normalizacion;
+        medida.impulsoMaximos[(size_t)x] = rango.getEnd() * normalizacion;
+    }
+
+    medida.retardoMs = float(double(pico - DeconvolucionDeBarrido::muestrasPrevias) / muestrasPorMs);
+
+    medidaFifo.push(medida);
+}
+
+void AnalisisDeDistorsion::recogeResultado()
+{
+    while (resultadoFifo.getNumAvailableForReading() > 0)
+        resultadoFifo.pull(resultadoParaDibujar);
+
+    if (!activo.load())
+        resultadoParaDibujar = {};
+}
+
+bool AnalisisDeDistorsion::hayTrabajoPendiente()
+{
+    return activo.load() && canalFIFO->getNumCompleteBuffersAvailable() > 0;
+}
+
+void AnalisisDeDistorsion::ejecuta()
+{
+    //el tono dejo de sonar y ha vuelto: lo que queda en cola es de antes del hueco
+    auto generacion = canalFIFO->getGeneracion();
+
+    if (generacion != generacionLeida)
+    {
+        generacionLeida = generacion;
+
+        while (canalFIFO->getNumCompleteBuffersAvailable() > 0)
+            canalFIFO->getAudioBuffer(bloque);
+
+        muestrasValidas = 0;
+        muestrasNuevas = 0;
+        return;
+    }
+
+    analizador.prepare();
+
+    const auto fftSize = analizador.getFFTSize();
+
+    if ((int)anillo.size() != fftSize)
+    {
+        anillo.assign((size_t)fftSize, 0.f);
+        trama.assign((size_t)fftSize, 0.f);
+        posicionEscritura = 0;
+        muestrasValidas = 0;
+    }
+
+    while (canalFIFO->getNumCompleteBuffersAvailable() > 0)
+    {
+        if (!canalFIFO->getAudioBuffer(bloque))
+            break;
+
+        auto* lectura = bloque.getReadPointer(0);
+        const auto numMuestras = bloque.getNumSamples();
+
+        for (int i = 0; i < numMuestras; ++i)
+        {
+            anillo[(size_t)posicionEscritura] = lectura[i];
+            posicionEscritura = (posicionEscritura + 1) % fftSize;
+        }
+
+        muestrasValidas = juce::jmin(fftSize, muestrasValidas + numMuestras);
+        muestrasNuevas += numMuestras;
+    }
+
+    const auto sampleRate = frecuenciaMuestreo.load();
+
+    if (muestrasValidas < fftSize || muestrasNuevas < muestrasEntreAnalisis || sampleRate <= 0.0)
+        return;
+
+    muestrasNuevas = 0;
+
+    //lo mas antiguo empieza donde se va a escribir
+    std::copy(anillo.begin() + posicionEscritura, anillo.end(), trama.begin());
+    std::copy(anillo.begin(), anillo.begin() + posicionEscritura, trama.begin() + (fftSize - posicionEscritura));
+
+    resultadoFifo.push(analizador.process(trama.data(), sampleRate, BarridoSinusoidal::frecuenciaTono));
+}
+
+bool ParDeCanales::compruebaGeneracion()
+{
+    const auto generacionIzq = canalIzq->getGeneracion();
+    const auto generacionDer = canalDer->getGeneracion();
+
+    if (generacionIzq == generacionIzqLeida && generacionDer == generacionDerLeida)
+        return false;
 
-    for (size_t i = 1; i < mags.size(); ++i)
-    {
-        onda.lineTo(responseArea.getX() + i, map(mags[i]));
-    }
+    //si el hilo de audio esta entre los dos reanuda(), la proxima llamada lo vuelve a ver y tira lo de entretanto
+    generacionIzqLeida = generacionIzq;
+    generacionDerLeida = generacionDer;
+
+    descartaPendientes();
+    vacia();
+    return true;
 }
 
-void ComponenteAnalizador::paint(juce::Graphics& g)
+void ParDeCanales::descartaPendientes()
 {
-    using namespace juce;
-    // (Rellenamos el findo con un color opaco)
-    g.fillAll(Colours::black);
+    while (canalIzq->getNumCompleteBuffersAvailable() > 0)
+        canalIzq->getAudioBuffer(bloqueIzq);
 
-    drawBackgroundGrid(g);
+    while (canalDer->getNumCompleteBuffersAvailable() > 0)
+        canalDer->getAudioBuffer(bloqueDer);
 
-    auto responseArea = getAnalysisArea();
+    hayBloqueIzq = false;
+    hayBloqueDer = false;
+}
 
-    if (shouldShowFFTAnalysis)
-    {
-        auto sealFFTCanalIzq = productorOndaIzq.getPath();
-        sealFFTCanalIzq.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+void ParDeCanales::prepara(int tamao)
+{
+    if ((int)anilloIzq.size() == tamao)
+        return;
 
-        g.setColour(Colour(73u, 243u, 242u)); //turquesa neon
-        g.strokePath(sealFFTCanalIzq, PathStrokeType(1.f));
+    anilloIzq.assign((size_t)tamao, 0.f);
+    anilloDer.assign((size_t)tamao, 0.f);
+    vacia();
+}
 
-        auto sealFFTCanalDer = productorOndaDer.getPath();
-        sealFFTCanalDer.applyTransform(AffineTransform().translation(responseArea.getX(), responseArea.getY()));
+void ParDeCanales::vacia()
+{
+    posicionEscritura = 0;
+    muestrasValidas = 0;
+    muestrasNuevas = 0;
+}
 
-        g.setColour(Colour(255u, 20u, 20u));//Rojo
-        g.strokePath(sealFFTCanalDer, PathStrokeType(1.f));
-    }
+bool ParDeCanales::emparejaBloques()
+{
+    for (;;)
+    {
+        if (!hayBloqueIzq)
+            hayBloqueIzq = canalIzq->getAudioBuffer(bloqueIzq, infoIzq);
 
-    g.setColour(Colours::white);
-    g.strokePath(onda, PathStrokeType(2.f));
+        if (!hayBloqueDer)
+            hayBloqueDer = canalDer->getAudioBuffer(bloqueDer, infoDer);
 
-    Path border;
+        if (!hayBloqueIzq || !hayBloqueDer)
+            return false;
 
-    border.setUsingNonZeroWinding(false);
+        if (infoIzq.numero == infoDer.numero)
+            return true;
 
-    border.addRoundedRectangle(getRenderArea(), 4);
-    border.addRectangle(getLocalBounds());
+        //el que va por detras perdio su pareja, que no cupo en el otro fifo
+        if (infoIzq.numero < infoDer.numero)
+            hayBloqueIzq = false;
+        else
+            hayBloqueDer = false;
+    }
+}
 
-    g.setColour(Colours::black);
+bool ParDeCanales::aadeSiguientePar()
+{
+    if (anilloIzq.empty() || !emparejaBloques())
+        return false;
 
-    g.fillPath(border);
+    hayBloqueIzq = false;
+    hayBloqueDer = false;
 
-    drawTextLabels(g);
+    const auto tamao = (int)anilloIzq.size();
+    auto* izq = bloqueIzq.getReadPointer(0);
+    auto* der = bloqueDer.getReadPointer(0);
+    const auto numMuestras = juce::jmin(bloqueIzq.getNumSamples(), bloqueDer.getNumSamples());
 
-    g.setColour(Colours::lavenderblush);
-    g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
+    for (int i = 0; i < numMuestras; ++i)
+    {
+        anilloIzq[(size_t)posicionEscritura] = izq[i];
+        anilloDer[(size_t)posicionEscritura] = der[i];
+        posicionEscritura = (posicionEscritura + 1) % tamao;
+    }
+
+    muestrasValidas = juce::jmin(tamao, muestrasValidas + numMuestras);
+    muestrasNuevas += numMuestras;
+    return true;
 }
 
-std::vector<float> ComponenteAnalizador::getFrequencies()
+void ParDeCanales::copiaUltimas(float* izq, float* der, int numMuestras) const
 {
-    return std::vector<float>
-    {
-        20, /*30, 40,*/ 50, 100,
-            200, /*300, 400,*/ 500, 1000,
-            2000, /*3000, 4000,*/ 5000, 10000,
-            20000
-    };
+    const auto tamao = (int)anilloIzq.size();
+    jassert(numMuestras <= tamao);
+
+    //desde 'inicio' hasta el final del anillo y el resto desde el principio
+    const auto inicio = (posicionEscritura - numMuestras + tamao) % tamao;
+    const auto primerTramo = juce::jmin(numMuestras, tamao - inicio);
+
+    std::copy(anilloIzq.begin() + inicio, anilloIzq.begin() + inicio + primerTramo, izq);
+    std::copy(anilloDer.begin() + inicio, anilloDer.begin() + inicio + primerTramo, der);
+    std::copy(anilloIzq.begin(), anilloIzq.begin() + (numMuestras - primerTramo), izq + primerTramo);
+    std::copy(anilloDer.begin(), anilloDer.begin() + (numMuestras - primerTramo), der + primerTramo);
 }
 
-std::vector<float> ComponenteAnalizador::getGains()
+void AnalisisEstereo::setParametrosDeRender(juce::Rectangle<float> fftBounds,
+    double sampleRate,
+    const ConfiguracionAnalizador& configuracion,
+    const EjeDeFrecuencias& eje)
 {
-    return std::vector<float>
-    {
-        -24, -12, 0, 12, 24
-    };
+    const juce::SpinLock::ScopedLockType sl(lockParametros);
+    limitesFFT = fftBounds;
+    frecuenciaMuestreo = sampleRate;
+    configuracionAnalizador = configuracion;
+    ejeDeDibujo = eje;
 }
 
-std::vector<float> ComponenteAnalizador::getXs(const std::vector<float>& freqs, float left, float width)
+void AnalisisEstereo::recogeSeal()
 {
-    std::vector<float> xs;
-    for (auto f : freqs)
+    while (productorMedio.getNumPathsAvailable() > 0)
+        productorMedio.getPath(sealMedio);
+
+    while (productorLado.getNumPathsAvailable() > 0)
+        productorLado.getPath(sealLado);
+
+    while (medidaFifo.getNumAvailableForReading() > 0)
+        medidaFifo.pull(medidaParaDibujar);
+
+    //al volver a la vista no se ensea lo de la vez anterior
+    if (!activo.load())
     {
-        auto normX = juce::mapFromLog10(f, 20.f, 20000.f);
-        xs.push_back(left + width * normX);
+        sealMedio.clear();
+        sealLado.clear();
+        medidaParaDibujar = {};
     }
+}
 
-    return xs;
+bool AnalisisEstereo::hayTrabajoPendiente()
+{
+    return activo.load() && par.hayBloquesPendientes();
 }
 
-void ComponenteAnalizador::drawBackgroundGrid(juce::Graphics& g)
+void AnalisisEstereo::ejecuta()
 {
-    using namespace juce;
-    auto freqs = getFrequencies();
+    juce::Rectangle<float> fftBounds;
+    double sampleRate;
+    ConfiguracionAnalizador configuracion;
+    EjeDeFrecuencias eje;
 
-    auto renderArea = getAnalysisArea();
-    auto left = renderArea.getX();
-    auto right = renderArea.getRight();
-    auto top = renderArea.getY();
-    auto bottom = renderArea.getBottom();
-    auto width = renderArea.getWidth();
+    {
+        const juce::SpinLock::ScopedLockType sl(lockParametros);
+        fftBounds = limitesFFT;
+        sampleRate = frecuenciaMuestreo;
+        configuracion = configuracionAnalizador;
+        eje = ejeDeDibujo;
+    }
 
-    auto xs = getXs(freqs, left, width);
+    //la vista se volvio a encender: el promedio empieza de cero
+    if (par.compruebaGeneracion())
+    {
+        analizador.reinicia();
+        return;
+    }
 
-    g.setColour(Colours::dimgrey);
-    for (auto x : xs)
+    if (fftBounds.isEmpty() || sampleRate <= 0.0)
     {
-        g.drawVerticalLine(x, top, bottom);
+        par.descartaPendientes();
+        return;
     }
 
-    auto gain = getGains();
+    analizador.prepare(ordenFFT);
 
-    for (auto gDb : gain)
+    const auto fftSize = analizador.getFFTSize();
+    const auto salto = fftSize / 2;
+
+    par.prepara(fftSize);
+    tramaIzq.resize((size_t)fftSize);
+    tramaDer.resize((size_t)fftSize);
+
+    //peso de cada trama en el promedio, el mismo que el de la traza en vivo
+    const auto alfa = 1.f / float(juce::jmax(1, configuracion.framesPromediados));
+    auto hayTramaNueva = false;
+
+    while (par.aadeSiguientePar())
     {
-        auto y = jmap(gDb, -24.f, 24.f, float(bottom), float(top));
+        if (par.getMuestrasValidas() < fftSize || par.getMuestrasNuevas() < salto)
+            continue;
 
-        g.setColour(gDb == 0.f ? Colour(0u, 172u, 1u) : Colours::darkgrey);
-        g.drawHorizontalLine(y, left, right);
+        par.descuentaMuestrasNuevas(salto);
+        par.copiaUltimas(tramaIzq.data(), tramaDer.data(), fftSize);
+
+        analizador.process(tramaIzq.data(), tramaDer.data(), alfa);
+        hayTramaNueva = true;
     }
+
+    if (hayTramaNueva)
+        publica(fftBounds, sampleRate, configuracion.vistaEstereo, eje);
 }
 
-void ComponenteAnalizador::drawTextLabels(juce::Graphics& g)
+void AnalisisEstereo::publica(juce::Rectangle<float> fftBounds,
+    double sampleRate,
+    VistaEstereo vista,
+    const EjeDeFrecuencias& eje)
 {
-    using namespace juce;
-    g.setColour(Colours::lightgrey);
-    const int fontHeight = 10;
-    g.setFont(fontHeight);
+    const auto width = (int)fftBounds.getWidth();
+    const auto numBins = analizador.getNumBins();
+    const auto binWidth = float(sampleRate / double(analizador.getFFTSize()));
 
-    auto renderArea = getAnalysisArea();
-    auto left = renderArea.getX();
+    if (width <= 0)
+        return;
 
-    auto top = renderArea.getY();
-    auto bottom = renderArea.getBottom();
-    auto width = renderArea.getWidth();
+    medida.correlacionGlobal = analizador.getCorrelacionGlobal();
 
-    auto freqs = getFrequencies();
-    auto xs = getXs(freqs, left, width);
+    if (vista == VistaEstereo::Estereo_MedioLado)
+    {
+        //la misma escala y el mismo suelo que la traza en vivo
+        const auto escala = 1.f / (float(numBins) * float(numBins));
 
-    for (int i = 0; i < freqs.size(); ++i)
+        espectroMedio = analizador.getPotenciaMedio();
+        espectroLado = analizador.getPotenciaLado();
+
+        OperacionesVectoriales::potenciasADecibelios(espectroMedio.data(), numBins, escala, -48.f);
+        OperacionesVectoriales::potenciasADecibelios(espectroLado.data(), numBins, escala, -48.f);
+
+        productorMedio.generatePath(espectroMedio, numBins, fftBounds, binWidth, -48.f, eje, 0.f);
+        productorLado.generatePath(espectroLado, numBins, fftBounds, binWidth, -48.f, eje, 0.f);
+
+        medida.correlacion.clear();
+        medida.coherencia.clear();
+    }
+    else
     {
-        auto f = freqs[i];
-        auto x = xs[i];
+        mapa.sumaAColumnas(analizador.getGll(), width, numBins, binWidth, columnasLl, eje);
+        mapa.sumaAColumnas(analizador.getGrr(), width, numBins, binWidth, columnasRr, eje);
+        mapa.sumaAColumnas(analizador.getGlrRe(), width, numBins, binWidth, columnasLrRe, eje);
+        mapa.sumaAColumnas(analizador.getGlrIm(), width, numBins, binWidth, columnasLrIm, eje);
 
-        bool addK = false;
-        String str;
-        if (f > 999.f)
+        medida.correlacion.resize((size_t)width);
+        medida.coherencia.resize((size_t)width);
+
+        for (size_t x = 0; x < (size_t)width; ++x)
         {
-            addK = true;
-            f /= 1000.f;
+            const auto potencias = columnasLl[x] * columnasRr[x];
+
+            //las columnas sin seal en alguno de los dos canales no dicen nada, se quedan en cero
+            medida.correlacion[x] = potencias > 0.f
+                ? juce::jlimit(-1.f, 1.f, columnasLrRe[x] / std::sqrt(potencias))
+                : 0.f;
+
+            medida.coherencia[x] = potencias > 0.f
+                ? juce::jlimit(0.f, 1.f, (columnasLrRe[x] * columnasLrRe[x] + columnasLrIm[x] * columnasLrIm[x]) / potencias)
+                : 0.f;
         }
+    }
 
-        str << f;
-        if (addK)
-            str << "k";
-        str << "Hz";
+    medidaFifo.push(medida);
+}
 
-        auto textWidth = g.getCurrentFont().getStringWidth(str);
+void AnalisisDeRetardo::recogeResultado()
+{
+    while (resultadoFifo.getNumAvailableForReading() > 0)
+        resultadoFifo.pull(resultadoParaDibujar);
 
-        Rectangle<int> r;
+    if (!estaActivo())
+        resultadoParaDibujar = {};
+}
 
-        r.setSize(textWidth, fontHeight);
-        r.setCentre(x, 0);
-        r.setY(1);
+bool AnalisisDeRetardo::hayTrabajoPendiente()
+{
+    return estaActivo() && par.hayBloquesPendientes();
+}
 
-        g.drawFittedText(str, r, juce::Justification::centred, 1);
-    }
+void AnalisisDeRetardo::ejecuta()
+{
+    if (par.compruebaGeneracion())
+        return;
 
-    auto gain = getGains();
+    constexpr int tamaoMaximo = 1 << ordenMaximo;
 
-    for (auto gDb : gain)
+    //el anillo y las ventanas se reservan una vez, para la ventana mas grande
+    par.prepara(tamaoMaximo);
+
+    if ((int)ventanaIzq.size() != tamaoMaximo)
     {
-        auto y = jmap(gDb, -24.f, 24.f, float(bottom), float(top));
+        ventanaIzq.assign((size_t)tamaoMaximo, 0.f);
+        ventanaDer.assign((size_t)tamaoMaximo, 0.f);
+    }
 
-        String str;
-        if (gDb > 0)
-            str << "+";
-        str << gDb;
+    while (par.aadeSiguientePar())
+    {
+    }
 
-        auto textWidth = g.getCurrentFont().getStringWidth(str);
+    const auto orden = juce::jmin(ordenMaximo, ordenVentana.load());
+    const auto sampleRate = frecuenciaMuestreo.load();
 
-        Rectangle<int> r;
-        r.setSize(textWidth, fontHeight);
-        r.setX(getWidth() - textWidth);
-        r.setCentre(r.getCentreX(), y);
+    if (orden <= 0 || sampleRate <= 0.0)
+        return;
 
-        g.setColour(gDb == 0.f ? Colour(0u, 172u, 1u) : Colours::lightgrey);
+    const auto tamaoVentana = 1 << orden;
+    const auto muestrasEntreEstimaciones = juce::roundToInt(sampleRate / estimacionesPorSegundo);
 
-        g.drawFittedText(str, r, juce::Justification::centredLeft, 1);
+    if (par.getMuestrasValidas() < tamaoVentana || par.getMuestrasNuevas() < muestrasEntreEstimaciones)
+        return;
 
-        str.clear();
-        str << (gDb - 24.f);
+    par.descuentaMuestrasNuevas(par.getMuestrasNuevas());
+    par.copiaUltimas(ventanaIzq.data(), ventanaDer.data(), tamaoVentana);
 
-        r.setX(1);
-        textWidth = g.getCurrentFont().getStringWidth(str);
-        r.setSize(textWidth, fontHeight);
-        g.setColour(Colours::lightgrey);
-        g.drawFittedText(str, r, juce::Justification::centredLeft, 1);
-    }
+    estimador.prepare(orden);
+    resultadoFifo.push(estimador.process(ventanaIzq.data(), ventanaDer.data(), sampleRate));
 }
 
-void ComponenteAnalizador::resized()
+void AnalisisEstadistico::setParametrosDeRender(juce::Rectangle<float> fftBounds, double sampleRate, const EjeDeFrecuencias& eje)
 {
-    using namespace juce;
+    const juce::SpinLock::ScopedLockType sl(lockParametros);
+    limitesFFT = fftBounds;
+    frecuenciaMuestreo = sampleRate;
+    ejeDeDibujo = eje;
+}
 
-    onda.preallocateSpace(getWidth() * 3);
-    actualizaSeal();
+void AnalisisEstadistico::recogeSeal()
+{
+    for (size_t p = 0; p < productoresPercentiles.size(); ++p)
+        while (productoresPercentiles[p].getNumPathsAvailable() > 0)
+            productoresPercentiles[p].getPath(sealesPercentiles[p]);
+
+    while (productorSuelo.getNumPathsAvailable() > 0)
+        productorSuelo.getPath(sealSuelo);
+
+    //al volver a activarla no se ensea lo de la vez anterior
+    if (!activo.load())
+    {
+        for (auto& seal : sealesPercentiles)
+            seal.clear();
+
+        sealSuelo.clear();
+    }
 }
 
-void ComponenteAnalizador::parameterValueChanged(int parameterIndex, float newValue)
+bool AnalisisEstadistico::hayTrabajoPendiente()
 {
-    parametrosModificados.set(true);
+    return activo.load() && par.hayBloquesPendientes();
 }
 
-void ProductorDeOndas::process(juce::Rectangle<float> fftBounds, double sampleRate)
+void AnalisisEstadistico::ejecuta()
 {
-    juce::AudioBuffer<float> tempIncomingBuffer;
-    while (canalIzqFIFO->getNumCompleteBuffersAvailable() > 0)
+    juce::Rectangle<float> fftBounds;
+    double sampleRate;
+    EjeDeFrecuencias eje;
+
     {
-        if (canalIzqFIFO->getAudioBuffer(tempIncomingBuffer))
-        {
-            auto size = tempIncomingBuffer.getNumSamples();
+        const juce::SpinLock::ScopedLockType sl(lockParametros);
+        fftBounds = limitesFFT;
+        sampleRate = frecuenciaMuestreo;
+        eje = ejeDeDibujo;
+    }
+
+    //despues de un hueco la estadistica es de otra toma, empieza de cero
+    if (par.compruebaGeneracion())
+    {
+        estadistica.reinicia();
+        muestrasSinPublicar = 0;
+        segundosAnalizados.store(0.0);
+        return;
+    }
+
+    if (sampleRate <= 0.0)
+    {
+        par.descartaPendientes();
+        return;
+    }
 
-            juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, 0),
-                monoBuffer.getReadPointer(0, size),
-                monoBuffer.getNumSamples() - size);
+    //con otra frecuencia de muestreo cada bin es otra frecuencia
+    if (sampleRate != frecuenciaPreparada)
+    {
+        estadistica.prepare(sampleRate);
+        estadistica.reinicia();
+        frecuenciaPreparada = sampleRate;
+    }
 
-            juce::FloatVectorOperations::copy(monoBuffer.getWritePointer(0, monoBuffer.getNumSamples() - size),
-                tempIncomingBuffer.getReadPointer(0, 0),
-                size);
+    const auto fftSize = estadistica.getFFTSize();
+    const auto salto = estadistica.getSalto();
 
-            generadorDatosFFTCanalIzq.produceFFTDataForRendering(monoBuffer, -48.f);
-        }
+    par.prepara(fftSize);
+    tramaIzq.resize((size_t)fftSize);
+    tramaDer.resize((size_t)fftSize);
+
+    while (par.aadeSiguientePar())
+    {
+        if (par.getMuestrasValidas() < fftSize || par.getMuestrasNuevas() < salto)
+            continue;
+
+        par.descuentaMuestrasNuevas(salto);
+        par.copiaUltimas(tramaIzq.data(), tramaDer.data(), fftSize);
+
+        //medio: (L + R) / 2
+        juce::FloatVectorOperations::add(tramaIzq.data(), tramaDer.data(), fftSize);
+        juce::FloatVectorOperations::multiply(tramaIzq.data(), 0.5f, fftSize);
+
+        estadistica.process(tramaIzq.data());
+        muestrasSinPublicar += salto;
     }
 
-    const auto fftSize = generadorDatosFFTCanalIzq.getFFTSize();
-    const auto binWidth = sampleRate / double(fftSize);
+    segundosAnalizados.store(double(estadistica.getNumTramas()) * double(salto) / sampleRate);
 
-    while (generadorDatosFFTCanalIzq.getNumAvailableFFTDataBlocks() > 0)
+    if (muestrasSinPublicar < juce::roundToInt(sampleRate / publicacionesPorSegundo) || fftBounds.isEmpty())
+        return;
+
+    muestrasSinPublicar = 0;
+    publica(fftBounds, sampleRate, eje);
+}
+
+void AnalisisEstadistico::publica(juce::Rectangle<float> fftBounds, double sampleRate, const EjeDeFrecuencias& eje)
+{
+    const auto numBins = estadistica.getNumBins();
+    const auto binWidth = float(sampleRate / double(estadistica.getFFTSize()));
+
+    estadistica.getPercentiles(percentiles);
+    estadistica.getSueloDeRuido(suelo);
+
+    //el mismo suelo de dibujo que la traza en vivo
+    for (size_t p = 0; p < percentiles.size(); ++p)
     {
-        std::vector<float> datoFFT;
-        if (generadorDatosFFTCanalIzq.getFFTData(datoFFT))
-        {
-            productorDeSeal.generatePath(datoFFT, fftBounds, fftSize, binWidth, -48.f);
-        }
+        juce::FloatVectorOperations::max(percentiles[p].data(), percentiles[p].data(), -48.f, numBins);
+        productoresPercentiles[p].generatePath(percentiles[p], numBins, fftBounds, binWidth, -48.f, eje, 0.f);
     }
 
-    while (productorDeSeal.getNumPathsAvailable() > 0)
+    juce::FloatVectorOperations::max(suelo.data(), suelo.data(), -48.f, numBins);
+    productorSuelo.generatePath(suelo, numBins, fftBounds, binWidth, -48.f, eje, 0.f);
+}
+
+void ComponenteAnalizador::actualizaTrabajosDeAnalisis()
+{
+    auto fftBounds = getAnalysisArea().toFloat();
+    auto sampleRate = audioProcessor.getSampleRate();
+    auto configuracion = getConfiguracionAnalizador(audioProcessor.apvts);
+
+    mostrarPicos = configuracion.retenerPicos;
+    mostrarPreEcualizacion = configuracion.mostrarPreEcualizacion && configuracion.modo == ModoAnalizador::Modo_Normal;
+    modoAnalizador = configuracion.modo;
+    mostrarSonoridad = audioProcessor.apvts.getRawParameterValue("Medir Sonoridad")->load() > 0.5f;
+    mostrarTonos = (int)audioProcessor.apvts.getRawParameterValue("Rastreo de Tonos")->load() != RastreoDeTonos::Rastreo_Apagado;
+    vistaEstereo = configuracion.vistaEstereo;
+    vistaReferencia = configuracion.modo == ModoAnalizador::Modo_Normal ? configuracion.vistaReferencia : VistaReferencia::Referencia_Apagada;
+
+    auto nuevoEje = getEjeDeFrecuencias(configuracion);
+    if (nuevoEje != eje)
     {
-        productorDeSeal.getPath(sealFFTCanalIzq);
+        eje = nuevoEje;
+        actualizaSeal();
+    }
+
+    //los editores que no se ven siguen analizando, pero detras de los visibles
+    auto prioridad = isShowing() ? 1 : 0;
+
+    for (auto* productor : { &productorOndaIzq, &productorOndaDer })
+    {
+        productor->setParametrosDeRender(fftBounds, sampleRate, configuracion);
+        productor->setActivo(shouldShowFFTAnalysis);
+        productor->setPrioridad(prioridad);
     }
+
+    //el reanalisis va siempre detras del analisis en vivo
+    reanalisisCongelado.setParametrosDeRender(fftBounds, eje);
+    reanalisisCongelado.setPrioridad(prioridad - 1);
+
+    medidaConBarrido.setParametrosDeRender(fftBounds, eje);
+    medidaConBarrido.setPrioridad(prioridad - 1);
+
+    analisisDeDistorsion.setFrecuenciaDeMuestreo(sampleRate);
+    analisisDeDistorsion.setPrioridad(prioridad - 1);
+
+    //la vista estereo es parte del analisis en vivo
+    analisisEstereo.setParametrosDeRender(fftBounds, sampleRate, configuracion, eje);
+    analisisEstereo.setActivo(shouldShowFFTAnalysis && vistaEstereo != VistaEstereo::Estereo_Apagado);
+    analisisEstereo.setPrioridad(prioridad);
+
+    analisisDeRetardo.setOrdenVentana(shouldShowFFTAnalysis ? configuracion.ordenVentanaRetardo : 0);
+    analisisDeRetardo.setFrecuenciaDeMuestreo(sampleRate);
+    analisisDeRetardo.setPrioridad(prioridad - 1);
+
+    //es una medida larga, no le importa ir detras del analisis en vivo
+    analisisEstadistico.setParametrosDeRender(fftBounds, sampleRate, eje);
+    analisisEstadistico.setActivo(audioProcessor.apvts.getRawParameterValue("Estadistica Espectral")->load() > 0.5f);
+    analisisEstadistico.setPrioridad(prioridad - 1);
+
+    audioProcessor.poolDeAnalisis->notifica();
 }
 
 void ComponenteAnalizador::timerCallback()
 {
+    actualizaTrabajosDeAnalisis();
+
     if (shouldShowFFTAnalysis)
     {
-        auto fftBounds = getAnalysisArea().toFloat();
-        auto sampleRate = audioProcessor.getSampleRate();
-
-        productorOndaIzq.process(fftBounds, sampleRate);
-        productorOndaDer.process(fftBounds, sampleRate);
+        productorOndaIzq.recogeSeal();
+        productorOndaDer.recogeSeal();
     }
 
+    reanalisisCongelado.recogeSeal();
+    medidaConBarrido.recogeSeal();
+    analisisDeDistorsion.recogeResultado();
+    analisisEstereo.recogeSeal();
+    analisisDeRetardo.recogeResultado();
+    analisisEstadistico.recogeSeal();
+
     if (parametrosModificados.compareAndSetBool(false, true))
     {
         updateChain();
@@ -630,6 +3696,16 @@ MonitorDeEspectroDeSe
 
     componenteAnalizador(audioProcessor),
 
+    selectorSuavizado(*audioProcessor.apvts.getParameter("Suavizado Analizador")),
+    selectorModo(*audioProcessor.apvts.getParameter("Modo Analizador")),
+    selectorPromediado(*audioProcessor.apvts.getParameter("Promediado Analizador")),
+    selectorMarcas(*audioProcessor.apvts.getParameter("Marcar Picos")),
+    selectorDestinoBarrido(*audioProcessor.apvts.getParameter("Destino Barrido")),
+    selectorEstereo(*audioProcessor.apvts.getParameter("Vista Estereo")),
+    selectorRetardo(*audioProcessor.apvts.getParameter("Ventana Retardo")),
+    selectorTonos(*audioProcessor.apvts.getParameter("Rastreo de Tonos")),
+    selectorReferencia(*audioProcessor.apvts.getParameter("Vista Referencia")),
+
     AttachmentSliderFrecuenciaPico(audioProcessor.apvts, "Frecuencia Pico", sliderFrecuenciaPico),
     AttachmentSliderVolumenPico(audioProcessor.apvts, "Volumen Pico", sliderVolumenPico),
     AttachmentSliderCalidadPico(audioProcessor.apvts, "Calidad Pico", sliderCalidadPico),
@@ -641,8 +3717,30 @@ MonitorDeEspectroDeSe
     AttachmentBypassBotonBajo(audioProcessor.apvts, "Bypass Bajo", botonBypassBajo),
     AttachmentBotonBypassPico(audioProcessor.apvts, "Bypass Pico", botonBypassPico),
     AttachmentBotonBypassAlto(audioProcessor.apvts, "Bypass Alto", botonBypassAlto),
-    AttachmentBotonAnalizadorHabilitado(audioProcessor.apvts, "Analizador Activado", botonAnalizadorHabilitado)
+    AttachmentBotonAnalizadorHabilitado(audioProcessor.apvts, "Analizador Activado", botonAnalizadorHabilitado),
+    AttachmentBotonRetenerPicos(audioProcessor.apvts, "Retener Picos", botonRetenerPicos),
+    AttachmentBotonPreEcualizacion(audioProcessor.apvts, "Mostrar Pre EQ", botonPreEcualizacion),
+    AttachmentBotonSonoridad(audioProcessor.apvts, "Medir Sonoridad", botonSonoridad),
+    AttachmentBotonEstadistica(audioProcessor.apvts, "Estadistica Espectral", botonEstadistica),
+
+    AttachmentSelectorSuavizado(audioProcessor.apvts, "Suavizado Analizador", selectorSuavizado),
+    AttachmentSelectorModo(audioProcessor.apvts, "Modo Analizador", selectorModo),
+    AttachmentSelectorPromediado(audioProcessor.apvts, "Promediado Analizador", selectorPromediado),
+    AttachmentSelectorMarcas(audioProcessor.apvts, "Marcar Picos", selectorMarcas),
+    AttachmentSelectorDestinoBarrido(audioProcessor.apvts, "Destino Barrido", selectorDestinoBarrido),
+    AttachmentSelectorEstereo(audioProcessor.apvts, "Vista Estereo", selectorEstereo),
+    AttachmentSelectorRetardo(audioProcessor.apvts, "Ventana Retardo", selectorRetardo),
+    AttachmentSelectorTonos(audioProcessor.apvts, "Rastreo de Tonos", selectorTonos),
+    AttachmentSelectorReferencia(audioProcessor.apvts, "Vista Referencia", selectorReferencia)
 {
+    botonRetenerPicos.setButtonText("Picos");
+    botonCongelar.setButtonText("Congelar");
+    botonPreEcualizacion.setButtonText("Pre EQ");
+    botonBarrido.setButtonText("Barrido");
+    botonDistorsion.setButtonText("THD");
+    botonSonoridad.setButtonText("LUFS");
+    botonEstadistica.setButtonText("P10-90");
+
     sliderFrecuenciaPico.etiquetas.add({ 0.f, "20Hz" });
     sliderFrecuenciaPico.etiquetas.add({ 1.f, "20kHz" });
 
@@ -711,6 +3809,24 @@ MonitorDeEspectroDeSe
         }
     };
 
+    botonCongelar.onClick = [safePtr]()
+    {
+        if (auto* comp = safePtr.getComponent())
+            comp->componenteAnalizador.setCongelado(comp->botonCongelar.getToggleState());
+    };
+
+    botonBarrido.onClick = [safePtr]()
+    {
+        if (auto* comp = safePtr.getComponent())
+            comp->componenteAnalizador.setBarrido(comp->botonBarrido.getToggleState());
+    };
+
+    botonDistorsion.onClick = [safePtr]()
+    {
+        if (auto* comp = safePtr.getComponent())
+            comp->componenteAnalizador.setDistorsion(comp->botonDistorsion.getToggleState());
+    };
+
     botonAnalizadorHabilitado.onClick = [safePtr]()
     {
         if (auto* comp = safePtr.getComponent())
@@ -796,6 +3912,17 @@ void MonitorDeEspectroDeSe
 
     auto areaHabilitadaDelAnalizador = bounds.removeFromTop(25);
 
+    //a la derecha del boton, las medidas que no cambian la traza principal
+    auto areaMedidas = areaHabilitadaDelAnalizador.withTrimmedLeft(60).withTrimmedRight(5);
+    areaMedidas.removeFromTop(3);
+    areaMedidas.setHeight(20);
+
+    selectorRetardo.setBounds(areaMedidas.removeFromRight(90));
+    areaMedidas.removeFromRight(5);
+    botonSonoridad.setBounds(areaMedidas.removeFromRight(55));
+    areaMedidas.removeFromRight(5);
+    selectorTonos.setBounds(areaMedidas.removeFromRight(105));
+
     areaHabilitadaDelAnalizador.setWidth(50);
     areaHabilitadaDelAnalizador.setX(5);
     areaHabilitadaDelAnalizador.removeFromTop(2);
@@ -811,6 +3938,49 @@ void MonitorDeEspectroDeSe
 
     bounds.removeFromTop(5);
 
+    auto areaOpcionesAnalizador = bounds.removeFromTop(20);
+    areaOpcionesAnalizador.removeFromLeft(20);
+
+    selectorSuavizado.setBounds(areaOpcionesAnalizador.removeFromLeft(85));
+    areaOpcionesAnalizador.removeFromLeft(5);
+    selectorModo.setBounds(areaOpcionesAnalizador.removeFromLeft(100));
+    areaOpcionesAnalizador.removeFromLeft(5);
+    selectorPromediado.setBounds(areaOpcionesAnalizador.removeFromLeft(95));
+    areaOpcionesAnalizador.removeFromLeft(5);
+    botonRetenerPicos.setBounds(areaOpcionesAnalizador.removeFromLeft(55));
+    areaOpcionesAnalizador.removeFromLeft(5);
+    selectorMarcas.setBounds(areaOpcionesAnalizador.removeFromLeft(80));
+
+    bounds.removeFromTop(2);
+
+    //segunda fila: lo que no es configuracion de la traza principal
+    auto areaVistasAnalizador = bounds.removeFromTop(20);
+    areaVistasAnalizador.removeFromLeft(20);
+
+    botonCongelar.setBounds(areaVistasAnalizador.removeFromLeft(70));
+    areaVistasAnalizador.removeFromLeft(5);
+    botonPreEcualizacion.setBounds(areaVistasAnalizador.removeFromLeft(65));
+    areaVistasAnalizador.removeFromLeft(5);
+    botonBarrido.setBounds(areaVistasAnalizador.removeFromLeft(70));
+    areaVistasAnalizador.removeFromLeft(5);
+    selectorDestinoBarrido.setBounds(areaVistasAnalizador.removeFromLeft(95));
+    areaVistasAnalizador.removeFromLeft(5);
+    botonDistorsion.setBounds(areaVistasAnalizador.removeFromLeft(50));
+    areaVistasAnalizador.removeFromLeft(5);
+    selectorEstereo.setBounds(areaVistasAnalizador.removeFromLeft(75));
+
+    bounds.removeFromTop(2);
+
+    //tercera fila: lo que se compara con la salida a lo largo del tiempo
+    auto areaComparacion = bounds.removeFromTop(20);
+    areaComparacion.removeFromLeft(20);
+
+    botonEstadistica.setBounds(areaComparacion.removeFromLeft(65));
+    areaComparacion.removeFromLeft(5);
+    selectorReferencia.setBounds(areaComparacion.removeFromLeft(115));
+
+    bounds.removeFromTop(5);
+
     auto areaParteBaja = bounds.removeFromLeft(bounds.getWidth() * 0.33);
     auto areaParteAlta = bounds.removeFromRight(bounds.getWidth() * 0.5);
 
@@ -840,6 +4010,22 @@ std::vector<juce::Component*> MonitorDeEspectroDeSe
         &sliderPendienteBaja,
         &sliderPendienteAlta,
         &componenteAnalizador,
+        &selectorSuavizado,
+        &selectorModo,
+        &selectorPromediado,
+        &selectorMarcas,
+        &botonRetenerPicos,
+        &botonCongelar,
+        &botonPreEcualizacion,
+        &botonBarrido,
+        &selectorDestinoBarrido,
+        &botonDistorsion,
+        &selectorEstereo,
+        &botonEstadistica,
+        &selectorReferencia,
+        &selectorRetardo,
+        &botonSonoridad,
+        &selectorTonos,
 
         &botonBypassBajo,
         &botonBypassPico,
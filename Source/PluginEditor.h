@@ -10,231 +10,1667 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "OperacionesVectoriales.h"
+#include "MotorFFT.h"
+#include "DetectorDePicos.h"
+#include "EspectroReasignado.h"
+#include "FuncionDeTransferencia.h"
+#include "AnalizadorDeDistorsion.h"
+#include "AnalizadorEstereo.h"
+#include "EstimadorDeRetardo.h"
+#include "EstadisticaEspectral.h"
 
 enum FFTOrder
 {
+    order1024 = 10,
     order2048 = 11,
     order4096 = 12,
-    order8192 = 13
+    order8192 = 13,
+    order16384 = 14
+};
+
+/**
+ fractional-octave smoothing of a magnitude spectrum.
+ each bin is replaced by the rms of the bins within +-1/(2n) octave, read from a
+ prefix sum of the power, so a frame costs O(bins) whatever the smoothing width.
+ the window of each bin only depends on the bin index, so the table is rebuilt
+ only when the number of bins or the fraction change.
+ */
+struct SuavizadoFraccionalDeOctava
+{
+    void prepare(int numBins, int fraccionDeOctava)
+    {
+        if (numBins == binsPreparados && fraccionDeOctava == fraccionPreparada)
+            return;
+
+        binsPreparados = numBins;
+        fraccionPreparada = fraccionDeOctava;
+
+        limiteInferior.resize(numBins);
+        limiteSuperior.resize(numBins);
+        sumaAcumulada.resize(numBins + 1);
+
+        if (fraccionDeOctava <= 0)
+            return;
+
+        const auto factor = std::pow(2.0, 1.0 / (2.0 * fraccionDeOctava));
+
+        //el DC no se mezcla con nada
+        limiteInferior[0] = limiteSuperior[0] = 0;
+
+        for (int bin = 1; bin < numBins; ++bin)
+        {
+            auto lo = (int)std::round(bin / factor);
+            auto hi = (int)std::round(bin * factor);
+
+            limiteInferior[bin] = juce::jlimit(1, bin, lo);
+            limiteSuperior[bin] = juce::jlimit(bin, numBins - 1, hi);
+        }
+    }
+
+    bool isActive() const { return fraccionPreparada > 0; }
+
+    //'potencias' holds at least the numBins passed to prepare() as linear power, non-finite values count as 0
+    void process(float* potencias)
+    {
+        if (!isActive())
+            return;
+
+        sumaAcumulada[0] = 0.0;
+        for (int bin = 0; bin < binsPreparados; ++bin)
+        {
+            auto v = (double)potencias[bin];
+            sumaAcumulada[bin + 1] = sumaAcumulada[bin] + (std::isfinite(v) ? v : 0.0);
+        }
+
+        for (int bin = 0; bin < binsPreparados; ++bin)
+        {
+            auto lo = limiteInferior[bin];
+            auto hi = limiteSuperior[bin];
+            auto potencia = (sumaAcumulada[hi + 1] - sumaAcumulada[lo]) / double(hi - lo + 1);
+            potencias[bin] = (float)juce::jmax(0.0, potencia);
+        }
+    }
+private:
+    int binsPreparados = 0, fraccionPreparada = 0;
+    std::vector<int> limiteInferior, limiteSuperior;
+    std::vector<double> sumaAcumulada;
+};
+
+/*
+ per-bin averaging of linear power frames: exponential with a time constant,
+ linear over the last N frames or attack/release ballistics, plus an optional
+ peak hold that decays at a fixed rate in dB/s.
+ */
+struct PromediadorEspectral
+{
+    void setConfiguracion(const ConfiguracionAnalizador& configuracion)
+    {
+        if (configuracion.promediado != modo || configuracion.framesPromediados != framesPromediados)
+        {
+            estado.clear();
+            historial.clear();
+        }
+
+        if (configuracion.retenerPicos != retenerPicos)
+            picos.clear();
+
+        modo = configuracion.promediado;
+        framesPromediados = juce::jmax(1, configuracion.framesPromediados);
+        tiempoPromediadoMs = configuracion.tiempoPromediadoMs;
+        ataqueMs = configuracion.ataqueMs;
+        liberacionMs = configuracion.liberacionMs;
+        retenerPicos = configuracion.retenerPicos;
+        caidaPicosDbPorSegundo = configuracion.caidaPicosDbPorSegundo;
+    }
+
+    //averages 'potencias' in place, 'duracionDelFrame' is the time in seconds since the previous frame
+    void process(float* potencias, int numBins, double duracionDelFrame)
+    {
+        if (numBins != binsPreparados)
+        {
+            binsPreparados = numBins;
+            estado.clear();
+            historial.clear();
+            picos.clear();
+        }
+
+        switch (modo)
+        {
+        case ModoPromediado::Promediado_Exponencial:
+        {
+            auto coef = getCoeficiente(tiempoPromediadoMs, duracionDelFrame);
+            filtra(potencias, coef, coef);
+            break;
+        }
+        case ModoPromediado::Promediado_Balistica:
+            filtra(potencias, getCoeficiente(ataqueMs, duracionDelFrame), getCoeficiente(liberacionMs, duracionDelFrame));
+            break;
+        case ModoPromediado::Promediado_Lineal:
+            promedioLineal(potencias);
+            break;
+        case ModoPromediado::Promediado_Ninguno:
+            break;
+        }
+
+        if (!retenerPicos)
+            return;
+
+        if (picos.size() != size_t(numBins))
+        {
+            picos.assign(potencias, potencias + numBins);
+            return;
+        }
+
+        //la caida esta en dB/s y los picos en potencia
+        auto caida = (float)std::pow(10.0, -0.1 * caidaPicosDbPorSegundo * duracionDelFrame);
+        juce::FloatVectorOperations::multiply(picos.data(), caida, numBins);
+        juce::FloatVectorOperations::max(picos.data(), picos.data(), potencias, numBins);
+    }
+
+    bool retienePicos() const { return retenerPicos && !picos.empty(); }
+    const std::vector<float>& getPicos() const { return picos; }
+private:
+    //coeficiente de un polo para que el paso de un escalon llegue al 63% en 'tiempoMs'
+    static float getCoeficiente(float tiempoMs, double duracionDelFrame)
+    {
+        if (tiempoMs <= 0.f)
+            return 1.f;
+
+        return (float)(1.0 - std::exp(-1000.0 * duracionDelFrame / double(tiempoMs)));
+    }
+
+    void filtra(float* potencias, float coefSubida, float coefBajada)
+    {
+        if (estado.size() != size_t(binsPreparados))
+        {
+            //el primer frame arranca el filtro, sin subir desde el silencio
+            estado.assign(potencias, potencias + binsPreparados);
+            return;
+        }
+
+        OperacionesVectoriales::seguimientoBalistico(estado.data(), potencias, binsPreparados, coefSubida, coefBajada);
+    }
+
+    void promedioLineal(float* potencias)
+    {
+        const auto n = binsPreparados;
+
+        if (historial.size() != size_t(n * framesPromediados))
+        {
+            historial.assign(size_t(n * framesPromediados), 0.f);
+            estado.assign(size_t(n), 0.f);
+            siguienteFrame = 0;
+            framesAcumulados = 0;
+        }
+
+        //estado guarda la suma de los frames del historial
+        auto* hueco = historial.data() + n * siguienteFrame;
+
+        if (framesAcumulados == framesPromediados)
+            juce::FloatVectorOperations::subtract(estado.data(), hueco, n);
+        else
+            ++framesAcumulados;
+
+        juce::FloatVectorOperations::copy(hueco, potencias, n);
+        juce::FloatVectorOperations::add(estado.data(), potencias, n);
+
+        siguienteFrame = (siguienteFrame + 1) % framesPromediados;
+
+        //al dar la vuelta rehacemos la suma para que no acumule error de redondeo
+        if (siguienteFrame == 0)
+        {
+            juce::FloatVectorOperations::copy(estado.data(), historial.data(), n);
+            for (int frame = 1; frame < framesPromediados; ++frame)
+                juce::FloatVectorOperations::add(estado.data(), historial.data() + n * frame, n);
+        }
+
+        juce::FloatVectorOperations::multiply(potencias, estado.data(), 1.f / float(framesAcumulados), n);
+    }
+
+    ModoPromediado modo{ ModoPromediado::Promediado_Ninguno };
+    int framesPromediados = 1;
+    float tiempoPromediadoMs = 0.f, ataqueMs = 0.f, liberacionMs = 0.f;
+    bool retenerPicos = false;
+    float caidaPicosDbPorSegundo = 0.f;
+
+    int binsPreparados = 0;
+    std::vector<float> estado, historial, picos;
+    int siguienteFrame = 0, framesAcumulados = 0;
 };
 
 template<typename BlockType>
 struct GeneradorDeDatosFFT
 {
-    /**
-     produces the FFT data from an audio buffer.
-     */
-    void produceFFTDataForRendering(const juce::AudioBuffer<float>& audioData, const float negativeInfinity)
-    {
-        const auto fftSize = getFFTSize();
+    /**
+     produces the FFT data from an audio buffer.
+     */
+    void produceFFTDataForRendering(const juce::AudioBuffer<float>& audioData, const float negativeInfinity, double duracionDelFrame)
+    {
+        produceFFTDataForRendering(audioData.getReadPointer(0), negativeInfinity, duracionDelFrame);
+    }
+
+    /**
+     same, reading getFFTSize() samples starting at 'readIndex'.
+     'duracionDelFrame' is the time since the previous frame, used by the averaging.
+     */
+    void produceFFTDataForRendering(const float* readIndex, const float negativeInfinity, double duracionDelFrame)
+    {
+        const auto fftSize = getFFTSize();
+
+        datoFFT.assign(datoFFT.size(), 0);
+        std::copy(readIndex, readIndex + fftSize, datoFFT.begin());
+
+        // first apply a windowing function to our data
+        window->multiplyWithWindowingTable(datoFFT.data(), fftSize);       // [1]
+
+        // then render our FFT data.. smoothing and averaging work on power
+        forwardFFT->transformadaSoloPotencia(datoFFT.data());              // [2]
+
+        int numBins = (int)fftSize / 2;
+
+        // smooth before normalizing, it is linear so the order doesn't matter
+        suavizado.prepare(numBins, fraccionDeOctava);
+        suavizado.process(datoFFT.data());
+
+        promediador.process(datoFFT.data(), numBins, duracionDelFrame);
+
+        enSuelo = false;
+        publica(numBins, negativeInfinity);
+    }
+
+    /**
+     a frame known to be below the display floor: window, FFT and smoothing are skipped
+     and the averaging is fed with silence, so decays and the peak hold keep falling.
+     returns false without pushing anything once the output has settled on the floor.
+     */
+    bool produceTramaSilenciosa(const float negativeInfinity, double duracionDelFrame)
+    {
+        if (enSuelo)
+            return false;
+
+        const auto numBins = getFFTSize() / 2;
+
+        std::fill(datoFFT.begin(), datoFFT.begin() + numBins, 0.f);
+        promediador.process(datoFFT.data(), numBins, duracionDelFrame);
+
+        publica(numBins, negativeInfinity);
+
+        enSuelo = juce::FloatVectorOperations::findMaximum(datoFFT.data(), numBins) <= negativeInfinity
+            && (!promediador.retienePicos()
+                || juce::FloatVectorOperations::findMaximum(datoPicos.data(), numBins) <= negativeInfinity);
+
+        return true;
+    }
+
+    bool estaEnSuelo() const { return enSuelo; }
+
+    void changeOrder(FFTOrder newOrder)
+    {
+        //when you change order, recreate the window, forwardFFT, fifo, datoFFT
+        //also reset the fifoIndex
+        //things that need recreating should be created on the heap via std::make_unique<>
+
+        order = newOrder;
+        auto fftSize = getFFTSize();
+
+        //the engine (juce or in-tree) is picked per size by a startup benchmark, see MotorFFT.h
+        forwardFFT = creaMotorFFT(order);
+        window = std::make_shared<juce::dsp::WindowingFunction<float>>(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+
+        preparaBuffers();
+    }
+
+    /*
+     same order as 'otro', reusing its FFT engine and window table instead of building new ones.
+     both generators must then be used from the same thread, one frame after the other.
+     */
+    void comparteTransformadaDe(const GeneradorDeDatosFFT& otro)
+    {
+        order = otro.order;
+        forwardFFT = otro.forwardFFT;
+        window = otro.window;
+
+        preparaBuffers();
+    }
+
+    void setFraccionDeOctava(int nuevaFraccion) { fraccionDeOctava = nuevaFraccion; }
+    void setPromediado(const ConfiguracionAnalizador& configuracion) { promediador.setConfiguracion(configuracion); }
+    //==============================================================================
+    int getFFTSize() const { return 1 << order; }
+    int getNumAvailableFFTDataBlocks() const { return datoFFTFifo.getNumAvailableForReading(); }
+    //==============================================================================
+    bool getFFTData(BlockType& datoFFT) { return datoFFTFifo.pull(datoFFT); }
+
+    //peak hold trace in dB, one block per FFT block while the peak hold is on
+    int getNumAvailablePeakBlocks() const { return datoPicosFifo.getNumAvailableForReading(); }
+    bool getPeakData(BlockType& picos) { return datoPicosFifo.pull(picos); }
+private:
+    void preparaBuffers()
+    {
+        auto fftSize = getFFTSize();
+
+        datoFFT.clear();
+        datoFFT.resize(fftSize * 2, 0);
+
+        datoFFTFifo.prepare(datoFFT.size());
+
+        datoPicos.assign(fftSize / 2, 0);
+        datoPicosFifo.prepare(datoPicos.size());
+
+        enSuelo = false;
+    }
+
+    //normalize and convert to decibels in one vectorized pass, (1 / numBins)^2 in power
+    void publica(int numBins, const float negativeInfinity)
+    {
+        const auto escala = 1.f / (float(numBins) * float(numBins));
+        OperacionesVectoriales::potenciasADecibelios(datoFFT.data(), numBins, escala, negativeInfinity);
+
+        datoFFTFifo.push(datoFFT);
+
+        if (promediador.retienePicos())
+        {
+            const auto& picos = promediador.getPicos();
+            std::copy(picos.begin(), picos.end(), datoPicos.begin());
+            OperacionesVectoriales::potenciasADecibelios(datoPicos.data(), numBins, escala, negativeInfinity);
+
+            datoPicosFifo.push(datoPicos);
+        }
+    }
+
+    FFTOrder order;
+    BlockType datoFFT;
+
+    //compartidos con otro generador del mismo tamao, ver comparteTransformadaDe()
+    std::shared_ptr<MotorFFT> forwardFFT;
+    std::shared_ptr<juce::dsp::WindowingFunction<float>> window;
+
+    SuavizadoFraccionalDeOctava suavizado;
+    int fraccionDeOctava = 0;
+
+    PromediadorEspectral promediador;
+    BlockType datoPicos;
+
+    //la ultima trama publicada ya estaba entera en el suelo y sigue sin llegar seal
+    bool enSuelo = false;
+
+    Fifo<BlockType> datoFFTFifo, datoPicosFifo;
+};
+
+/*
+ frequency axis of the analyzer display: 20 Hz - 20 kHz log by default,
+ or a linear band in zoom mode.
+ */
+struct EjeDeFrecuencias
+{
+    float desde = 20.f, hasta = 20000.f;
+    bool logaritmico = true;
+
+    float aNormalizado(float frecuencia) const
+    {
+        return logaritmico ? juce::mapFromLog10(frecuencia, desde, hasta)
+                           : (frecuencia - desde) / (hasta - desde);
+    }
+
+    float aFrecuencia(float normX) const
+    {
+        return logaritmico ? juce::mapToLog10(normX, desde, hasta)
+                           : desde + normX * (hasta - desde);
+    }
+
+    bool operator== (const EjeDeFrecuencias& otro) const
+    {
+        return desde == otro.desde && hasta == otro.hasta && logaritmico == otro.logaritmico;
+    }
+
+    bool operator!= (const EjeDeFrecuencias& otro) const { return !(*this == otro); }
+};
+
+inline EjeDeFrecuencias getEjeDeFrecuencias(const ConfiguracionAnalizador& configuracion)
+{
+    if (configuracion.modo == ModoAnalizador::Modo_Zoom)
+        return { configuracion.zoomDesde, configuracion.zoomHasta, false };
+
+    return {};
+}
+
+enum class AgregacionColumnas
+{
+    Maximo,
+    PromedioPotencia
+};
+
+/*
+ precomputed bin->pixel column table for one spectrum layout.
+ it is only rebuilt when width, number of bins, bin width or axis change.
+ */
+struct MapaDeColumnas
+{
+    /*
+     reduces the dB bins of 'renderData[]' to one value per pixel column.
+     bin k sits at frecuenciaPrimerBin + k * binWidth.
+     */
+    const std::vector<float>& reduceAColumnas(const std::vector<float>& renderData,
+        int width,
+        int numBins,
+        float binWidth,
+        AgregacionColumnas agregacion,
+        const EjeDeFrecuencias& eje = {},
+        float frecuenciaPrimerBin = 0.f)
+    {
+        prepara(width, numBins, binWidth, eje, frecuenciaPrimerBin);
+
+        for (int x = 0; x < width; ++x)
+        {
+            const auto& columna = columnas[x];
+
+            if (columna.primerBin > columna.ultimoBin)
+            {
+                //columna de graves sin ningun bin propio: interpolamos entre los vecinos
+                auto bin = (int)columna.binFraccional;
+                auto frac = columna.binFraccional - (float)bin;
+                valoresPorColumna[x] = renderData[bin] + frac * (renderData[bin + 1] - renderData[bin]);
+            }
+            else if (agregacion == AgregacionColumnas::Maximo)
+            {
+                auto first = renderData.begin() + columna.primerBin;
+                auto last = renderData.begin() + columna.ultimoBin + 1;
+                valoresPorColumna[x] = *std::max_element(first, last);
+            }
+            else
+            {
+                float potencia = 0.f;
+                for (int bin = columna.primerBin; bin <= columna.ultimoBin; ++bin)
+                    potencia += std::pow(10.f, renderData[bin] * 0.1f);
+
+                potencia /= float(columna.ultimoBin - columna.primerBin + 1);
+                valoresPorColumna[x] = 10.f * std::log10(potencia);
+            }
+        }
+
+        return valoresPorColumna;
+    }
+
+    /*
+     reassigned spectrum: adds each bin's linear power to the column of the (fractional)
+     bin position it was reassigned to. negative positions are skipped. 'potenciasPorColumna'
+     gets one linear power per column, 0 where nothing landed.
+     */
+    void esparceAColumnas(const std::vector<float>& potencias,
+        const std::vector<float>& binesReasignados,
+        int width,
+        int numBins,
+        float binWidth,
+        std::vector<float>& potenciasPorColumna,
+        const EjeDeFrecuencias& eje = {},
+        float frecuenciaPrimerBin = 0.f)
+    {
+        prepara(width, numBins, binWidth, eje, frecuenciaPrimerBin);
+
+        potenciasPorColumna.assign(size_t(width), 0.f);
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            auto posicion = binesReasignados[bin];
+
+            if (posicion < bordesEnBins.front() || posicion >= bordesEnBins.back() || posicion >= float(numBins))
+                continue;
+
+            //la tabla da la columna del bin entero, avanzamos lo que falte por la parte fraccional
+            auto x = juce::jmax(0, columnaDeBin[(int)posicion]);
+            while (x + 1 < width && bordesEnBins[x + 1] <= posicion)
+                ++x;
+
+            potenciasPorColumna[x] += potencias[bin];
+        }
+    }
+
+    /*
+     adds up the linear values of each column's bins, columns without a bin of their own
+     take the nearest one. for cross spectra the ratio of two column sums is the column's
+     estimate, weighted by power.
+     */
+    void sumaAColumnas(const std::vector<float>& valores,
+        int width,
+        int numBins,
+        float binWidth,
+        std::vector<float>& porColumna,
+        const EjeDeFrecuencias& eje = {},
+        float frecuenciaPrimerBin = 0.f)
+    {
+        prepara(width, numBins, binWidth, eje, frecuenciaPrimerBin);
+
+        porColumna.assign(size_t(width), 0.f);
+
+        for (int x = 0; x < width; ++x)
+        {
+            const auto& columna = columnas[x];
+
+            if (columna.primerBin > columna.ultimoBin)
+            {
+                porColumna[x] = valores[(size_t)juce::roundToInt(columna.binFraccional)];
+                continue;
+            }
+
+            for (int bin = columna.primerBin; bin <= columna.ultimoBin; ++bin)
+                porColumna[x] += valores[(size_t)bin];
+        }
+    }
+private:
+    struct ColumnaDelMapa
+    {
+        int primerBin = 0;
+        int ultimoBin = -1;
+        float binFraccional = 0.f;
+    };
+
+    void prepara(int width, int numBins, float binWidth, const EjeDeFrecuencias& eje, float frecuenciaPrimerBin)
+    {
+        if (width == anchoDelMapa && numBins == binsDelMapa && binWidth == binWidthDelMapa
+            && eje == ejeDelMapa && frecuenciaPrimerBin == primerBinDelMapa)
+            return;
+
+        anchoDelMapa = width;
+        binsDelMapa = numBins;
+        binWidthDelMapa = binWidth;
+        ejeDelMapa = eje;
+        primerBinDelMapa = frecuenciaPrimerBin;
+
+        columnas.resize(width);
+        valoresPorColumna.resize(width);
+        bordesEnBins.resize(width + 1);
+        columnaDeBin.resize(numBins);
+
+        auto binDeFrecuencia = [&eje, binWidth, frecuenciaPrimerBin](float normX)
+        {
+            return (eje.aFrecuencia(normX) - frecuenciaPrimerBin) / binWidth;
+        };
+
+        //el bin de DC solo se dibuja si el espectro no empieza en 0 Hz (zoom)
+        const int binMinimo = frecuenciaPrimerBin > 0.f ? 0 : 1;
+
+        for (int x = 0; x < width; ++x)
+        {
+            auto& columna = columnas[x];
+
+            //los bins cuyo floor(eje.aNormalizado(f) * width) cae en esta columna
+            auto binIzq = binDeFrecuencia(float(x) / float(width));
+            auto binDer = binDeFrecuencia(float(x + 1) / float(width));
+
+            bordesEnBins[x] = binIzq;
+            bordesEnBins[x + 1] = binDer;
+
+            columna.primerBin = juce::jlimit(binMinimo, numBins - 1, (int)std::ceil(binIzq));
+            columna.ultimoBin = juce::jlimit(0, numBins - 1, (int)std::ceil(binDer) - 1);
+
+            if (columna.primerBin > columna.ultimoBin)
+            {
+                columna.ultimoBin = columna.primerBin - 1;
+                columna.binFraccional = juce::jlimit(0.f, float(numBins - 2),
+                    binDeFrecuencia((float(x) + 0.5f) / float(width)));
+            }
+        }
+
+        //columna en la que cae cada bin entero, -1 para los que quedan a la izquierda del eje
+        for (int bin = 0, x = 0; bin < numBins; ++bin)
+        {
+            while (x + 1 < width && bordesEnBins[x + 1] <= float(bin))
+                ++x;
+
+            columnaDeBin[bin] = float(bin) < bordesEnBins.front() ? -1 : x;
+        }
+    }
+
+    std::vector<ColumnaDelMapa> columnas;
+    std::vector<float> valoresPorColumna;
+    std::vector<float> bordesEnBins;
+    std::vector<int> columnaDeBin;
+    int anchoDelMapa = 0, binsDelMapa = 0;
+    float binWidthDelMapa = 0.f, primerBinDelMapa = 0.f;
+    EjeDeFrecuencias ejeDelMapa;
+};
+
+/*
+ one band of a multi-resolution frame: its dB bins and the frequency where the
+ next (smaller, faster) band takes over.
+ */
+struct BandaDeAnalisis
+{
+    const std::vector<float>* renderData = nullptr;
+    int fftSize = 0;
+    float binWidth = 0.f;
+    float frecuenciaDeCorte = 0.f;
+};
+
+template<typename PathType>
+struct GeneradorDeSealParaAnalizador
+{
+    /*
+     converts 'renderData[]' into a juce::Path with exactly one point per pixel column
+     */
+    void generatePath(const std::vector<float>& renderData,
+        juce::Rectangle<float> fftBounds,
+        int fftSize,
+        float binWidth,
+        float negativeInfinity)
+    {
+        generatePath(renderData, fftSize / 2, fftBounds, binWidth, negativeInfinity, {}, 0.f);
+    }
+
+    /*
+     same, for a spectrum of 'numBins' starting at 'frecuenciaPrimerBin', drawn on 'eje'.
+     */
+    void generatePath(const std::vector<float>& renderData,
+        int numBins,
+        juce::Rectangle<float> fftBounds,
+        float binWidth,
+        float negativeInfinity,
+        const EjeDeFrecuencias& eje,
+        float frecuenciaPrimerBin)
+    {
+        auto width = (int)fftBounds.getWidth();
+
+        if (width <= 0)
+            return;
+
+        mapas.resize(juce::jmax((size_t)1, mapas.size()));
+        const auto& valores = mapas[0].reduceAColumnas(renderData, width, numBins, binWidth, agregacion, eje, frecuenciaPrimerBin);
+
+        pathFifo.push(construyePath(valores, fftBounds, negativeInfinity));
+    }
+
+    /*
+     builds one trace from several FFT sizes, ordered from the largest (lowest
+     frequencies) to the smallest. neighbouring bands are crossfaded over
+     +-1/6 octave around each cut frequency.
+     */
+    void generatePathMultiResolucion(const std::vector<BandaDeAnalisis>& bandas,
+        juce::Rectangle<float> fftBounds,
+        float negativeInfinity)
+    {
+        auto width = (int)fftBounds.getWidth();
+
+        if (width <= 0 || bandas.empty())
+            return;
+
+        mapas.resize(juce::jmax(bandas.size(), mapas.size()));
+        preparaFrecuenciasDeColumna(width);
+
+        mezcla = mapas[0].reduceAColumnas(*bandas[0].renderData, width, bandas[0].fftSize / 2, bandas[0].binWidth, agregacion);
+
+        constexpr float mediaTransicion = 1.f / 6.f; //octavas
+
+        for (size_t b = 1; b < bandas.size(); ++b)
+        {
+            const auto& banda = bandas[b];
+            const auto& valores = mapas[b].reduceAColumnas(*banda.renderData, width, banda.fftSize / 2, banda.binWidth, agregacion);
+            const auto corte = bandas[b - 1].frecuenciaDeCorte;
+
+            for (int x = 0; x < width; ++x)
+            {
+                auto octavas = std::log2(frecuenciasDeColumna[x] / corte);
+                auto t = juce::jlimit(0.f, 1.f, (octavas + mediaTransicion) / (2.f * mediaTransicion));
+                mezcla[x] += t * (valores[x] - mezcla[x]);
+            }
+        }
+
+        pathFifo.push(construyePath(mezcla, fftBounds, negativeInfinity));
+    }
+
+    /*
+     draws values that are already one per pixel column (in dB), e.g. a reassigned spectrum.
+     */
+    void generatePathDesdeColumnas(const std::vector<float>& valoresPorColumna,
+        juce::Rectangle<float> fftBounds,
+        float negativeInfinity)
+    {
+        if (valoresPorColumna.empty())
+            return;
+
+        pathFifo.push(construyePath(valoresPorColumna, fftBounds, negativeInfinity));
+    }
+
+    void setAgregacion(AgregacionColumnas nuevaAgregacion) { agregacion = nuevaAgregacion; }
+
+    int getNumPathsAvailable() const
+    {
+        return pathFifo.getNumAvailableForReading();
+    }
+
+    bool getPath(PathType& path)
+    {
+        return pathFifo.pull(path);
+    }
+private:
+    PathType construyePath(const std::vector<float>& valores,
+        juce::Rectangle<float> fftBounds,
+        float negativeInfinity)
+    {
+        auto top = fftBounds.getY();
+        auto bottom = fftBounds.getHeight();
+        auto width = (int)valores.size();
+
+        PathType p;
+        p.preallocateSpace(3 * width);
+
+        auto map = [bottom, top, negativeInfinity](float v)
+        {
+            auto y = juce::jmap(v,
+                negativeInfinity, 0.f,
+                float(bottom + 10), top);
+
+            if (std::isnan(y) || std::isinf(y))
+                y = bottom;
+
+            return y;
+        };
+
+        p.startNewSubPath(0, map(valores[0]));
+
+        for (int x = 1; x < width; ++x)
+        {
+            p.lineTo(x, map(valores[x]));
+        }
+
+        return p;
+    }
+
+    void preparaFrecuenciasDeColumna(int width)
+    {
+        if ((int)frecuenciasDeColumna.size() == width)
+            return;
+
+        frecuenciasDeColumna.resize(width);
+        for (int x = 0; x < width; ++x)
+            frecuenciasDeColumna[x] = juce::mapToLog10((float(x) + 0.5f) / float(width), 20.f, 20000.f);
+    }
+
+    Fifo<PathType> pathFifo;
+
+    AgregacionColumnas agregacion = AgregacionColumnas::Maximo;
+
+    std::vector<MapaDeColumnas> mapas;
+    std::vector<float> frecuenciasDeColumna, mezcla;
+};
+
+struct LookAndFeel : juce::LookAndFeel_V4
+{
+    void drawRotarySlider(juce::Graphics&,
+        int x, int y, int width, int height,
+        float sliderPosProportional,
+        float rotaryStartAngle,
+        float rotaryEndAngle,
+        juce::Slider&) override;
+
+    void drawToggleButton(juce::Graphics& g,
+        juce::ToggleButton& toggleButton,
+        bool shouldDrawButtonAsHighlighted,
+        bool shouldDrawButtonAsDown) override;
+};
+
+struct SliderRotatorioConEtiquetas : juce::Slider
+{
+    SliderRotatorioConEtiquetas(juce::RangedAudioParameter& rap, const juce::String& unitSuffix) :
+        juce::Slider(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag,
+            juce::Slider::TextEntryBoxPosition::NoTextBox),
+        param(&rap),
+        suffix(unitSuffix)
+    {
+        setLookAndFeel(&lnf);
+    }
+
+    ~SliderRotatorioConEtiquetas()
+    {
+        setLookAndFeel(nullptr);
+    }
+
+    struct PosicionEtiqueta
+    {
+        float pos;
+        juce::String etiqueta;
+    };
+
+    juce::Array<PosicionEtiqueta> etiquetas;
+
+    void paint(juce::Graphics& g) override;
+    juce::Rectangle<int> getSliderBounds() const;
+    int getTextHeight() const { return 14; }
+    juce::String getDisplayString() const;
+private:
+    LookAndFeel lnf;
+
+    juce::RangedAudioParameter* param;
+    juce::String suffix;
+};
+
+struct SelectorDeOpcion : juce::ComboBox
+{
+    SelectorDeOpcion(juce::RangedAudioParameter& rap)
+    {
+        //las opciones tienen que estar antes de crear el ComboBoxAttachment
+        if (auto* choiceParam = dynamic_cast<juce::AudioParameterChoice*>(&rap))
+            addItemList(choiceParam->choices, 1);
+
+        setTooltip(rap.getName(64));
+    }
+};
+
+/**
+ polyphase FIR decimator for the analyzer front end.
+ the lowpass is split into 'factor' phases, every input sample goes to one phase
+ delay line and one output is produced every 'factor' inputs, so the cost is
+ numTaps / factor multiply-adds per input sample.
+ */
+struct DiezmadorPolifasico
+{
+    void prepare(int nuevoFactor, const std::vector<float>& coeficientes)
+    {
+        factor = juce::jmax(1, nuevoFactor);
+        longitudFase = int(coeficientes.size() + size_t(factor) - 1) / factor;
+
+        fases.assign(size_t(factor), std::vector<float>(size_t(longitudFase), 0.f));
+        lineas.assign(size_t(factor), std::vector<float>(size_t(longitudFase) * 2, 0.f));
+
+        //E_p[n] = h[n * factor + p], guardado al reves para hacer el producto escalar hacia delante
+        for (int p = 0; p < factor; ++p)
+        {
+            for (int n = 0; n < longitudFase; ++n)
+            {
+                auto k = size_t(n * factor + p);
+                fases[size_t(p)][size_t(longitudFase - 1 - n)] = k < coeficientes.size() ? coeficientes[k] : 0.f;
+            }
+        }
+
+        posicion = 0;
+        contador = 0;
+    }
+
+    int getFactor() const { return factor; }
+
+    //empties the delay lines and the phase, as if just prepared
+    void reinicia()
+    {
+        for (auto& linea : lineas)
+            std::fill(linea.begin(), linea.end(), 0.f);
+
+        posicion = 0;
+        contador = 0;
+    }
+
+    //output samples still affected by an input sample, the tail of the FIR
+    int getMuestrasDeMemoria() const { return longitudFase; }
+
+    //returns the number of samples written to 'salida', at most numMuestras / factor + 1
+    int process(const float* entrada, int numMuestras, float* salida)
+    {
+        int numSalidas = 0;
+
+        for (int i = 0; i < numMuestras; ++i)
+        {
+            contador = (contador + 1) % factor;
+
+            //la muestra mM va a la fase 0, mM - p a la fase p
+            auto fase = contador == 0 ? 0 : factor - contador;
+            auto& linea = lineas[size_t(fase)];
+            linea[size_t(posicion)] = linea[size_t(posicion + longitudFase)] = entrada[i];
+
+            if (contador != 0)
+                continue;
+
+            float y = 0.f;
+            for (int p = 0; p < factor; ++p)
+            {
+                const auto* x = lineas[size_t(p)].data() + posicion + 1;
+                const auto* h = fases[size_t(p)].data();
+
+                for (int n = 0; n < longitudFase; ++n)
+                    y += h[n] * x[n];
+            }
+
+            salida[numSalidas++] = y;
+            posicion = (posicion + 1) % longitudFase;
+        }
+
+        return numSalidas;
+    }
+private:
+    int factor = 1, longitudFase = 1;
+    int posicion = 0, contador = 0;
+    std::vector<std::vector<float>> fases, lineas;
+};
+
+/**
+ zoom FFT: the selected band is shifted down to 0 Hz, low-pass filtered and
+ decimated as a complex signal in stages of up to 8x, then analysed with a small
+ complex FFT. the resolution is (decimated rate) / getNumBins() instead of
+ fs / N of a full-band transform.
+ */
+struct AnalizadorZoom
+{
+    static constexpr int ordenFFT = 9;
+
+    bool necesitaPreparar(double frecuenciaDeEntrada, float desde, float hasta) const
+    {
+        return frecuenciaDeEntrada != frecuenciaEntrada || desde != zoomDesde || hasta != zoomHasta;
+    }
+
+    void prepare(double frecuenciaDeEntrada, float desde, float hasta);
+    void setPromediado(const ConfiguracionAnalizador& configuracion) { promediador.setConfiguracion(configuracion); }
+
+    /**
+     returns true when a new spectrum in dB, fftshifted so it starts at getFrecuenciaPrimerBin(),
+     was written. 'picosDb' gets the peak hold trace, or is left empty when the peak hold is off.
+     */
+    bool process(const float* muestras,
+        int numMuestras,
+        std::vector<float>& espectroDb,
+        std::vector<float>& picosDb,
+        float negativeInfinity);
+
+    int getNumBins() const { return 1 << ordenFFT; }
+    float getAnchoDeBin() const { return float(frecuenciaSalida / double(getNumBins())); }
+    float getFrecuenciaPrimerBin() const { return float(frecuenciaCentral - 0.5 * frecuenciaSalida); }
+private:
+    void calculaEspectro(std::vector<float>& espectroDb, std::vector<float>& picosDb, double duracionDelFrame, float negativeInfinity);
+
+    double frecuenciaEntrada = 0.0, frecuenciaSalida = 0.0, frecuenciaCentral = 0.0;
+    float zoomDesde = 0.f, zoomHasta = 0.f;
+
+    //oscilador complejo e^(-i w n) del heterodino
+    std::complex<double> fasor{ 1.0, 0.0 }, rotacion{ 1.0, 0.0 };
+
+    std::vector<DiezmadorPolifasico> etapasI, etapasQ;
+    std::vector<float> bufferI, bufferQ;
+
+    std::vector<float> historialI, historialQ;
+    int muestrasPendientes = 0;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> ventana;
+    std::vector<juce::dsp::Complex<float>> entradaFFT, salidaFFT;
+
+    PromediadorEspectral promediador;
+};
+
+//niveles de las bandas de tercio de un canal, en dB con la escala de la traza (un seno de amplitud 1 da 0 dB)
+struct NivelesDeTercios
+{
+    static constexpr int numBandas = 31;
 
-        datoFFT.assign(datoFFT.size(), 0);
-        auto* readIndex = audioData.getReadPointer(0);
-        std::copy(readIndex, readIndex + fftSize, datoFFT.begin());
+    std::array<float, numBandas> nivelesDb{}, picosDb{};
+    std::array<bool, numBandas> disponibles{};
+    bool conPicos = false;
+};
 
-        // first apply a windowing function to our data
-        window->multiplyWithWindowingTable(datoFFT.data(), fftSize);       // [1]
+/**
+ 31-band 1/3-octave filterbank (base-10 centres, 20 Hz - 20 kHz), multirate.
+ each band is a 6th-order Butterworth bandpass, three biquads with the same
+ Filter/Coefficients as the EQ, followed by a mean-square detector with an
+ exponential time constant that runs per sample, so the ballistics do not
+ depend on how often the levels are read.
+
+ bands are grouped by octave. a band runs at the lowest rate fs / 2^s whose
+ quarter still holds its upper edge, and each stage is reached through an
+ 8th-order Butterworth lowpass at a third of its rate and a 2x decimation.
+ at 48 kHz the two top octaves run at full rate and every other octave at half
+ the rate of the one above, about 35 biquads per input sample instead of the 93
+ of running every band at fs. low bands also stay well clear of 0 Hz in
+ normalized frequency, where single-precision biquads lose accuracy.
+ */
+struct BancoDeTercios
+{
+    static constexpr int numBandas = NivelesDeTercios::numBandas;
+    static constexpr int seccionesPorBanda = 3;
 
-        // then render our FFT data..
-        forwardFFT->performFrequencyOnlyForwardTransform(datoFFT.data());  // [2]
+    //las bandas de una etapa quedan por debajo de un cuarto de su frecuencia de muestreo
+    static constexpr double limiteDeEtapa = 0.25;
 
-        int numBins = (int)fftSize / 2;
+    //de fs a fs / 1024, basta para la banda de 20 Hz hasta con 96 kHz
+    static constexpr int maxEtapas = 11;
 
-        //normalize the fft values.
-        for (int i = 0; i < numBins; ++i)
-        {
-            auto v = datoFFT[i];
-            //            datoFFT[i] /= (float) numBins;
-            if (!std::isinf(v) && !std::isnan(v))
-            {
-                v /= float(numBins);
-            }
-            else
-            {
-                v = 0.f;
-            }
-            datoFFT[i] = v;
-        }
+    //IEC 61672 "Fast"
+    static constexpr float tiempoRapidoMs = 125.f;
 
-        //convert them to decibels
-        for (int i = 0; i < numBins; ++i)
-        {
-            datoFFT[i] = juce::Decibels::gainToDecibels(datoFFT[i], negativeInfinity);
-        }
+    //f = 1000 * 10^(n / 10) con n = -17 ... 13, los bordes a 10^(+-1/20)
+    static float getFrecuenciaCentral(int banda) { return 1000.f * std::pow(10.f, float(banda - 17) / 10.f); }
+    static float getFrecuenciaInferior(int banda) { return getFrecuenciaCentral(banda) * std::pow(10.f, -0.05f); }
+    static float getFrecuenciaSuperior(int banda) { return getFrecuenciaCentral(banda) * std::pow(10.f, 0.05f); }
 
-        datoFFTFifo.push(datoFFT);
-    }
+    bool necesitaPreparar(double sampleRate) const { return sampleRate != frecuenciaPreparada; }
+    void prepare(double sampleRate);
 
-    void changeOrder(FFTOrder newOrder)
-    {
-        //when you change order, recreate the window, forwardFFT, fifo, datoFFT
-        //also reset the fifoIndex
-        //things that need recreating should be created on the heap via std::make_unique<>
+    //empties filters and detectors, e.g. after a gap in the audio
+    void reinicia();
 
-        order = newOrder;
-        auto fftSize = getFFTSize();
+    void setTiempoDeIntegracion(float tiempoMs);
 
-        forwardFFT = std::make_unique<juce::dsp::FFT>(order);
-        window = std::make_unique<juce::dsp::WindowingFunction<float>>(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+    void process(const float* muestras, int numMuestras);
 
-        datoFFT.clear();
-        datoFFT.resize(fftSize * 2, 0);
+    //mean square of each band times 2, the level of a sine of the same amplitude on the trace
+    void getPotencias(float* potencias) const;
 
-        datoFFTFifo.prepare(datoFFT.size());
-    }
-    //==============================================================================
-    int getFFTSize() const { return 1 << order; }
-    int getNumAvailableFFTDataBlocks() const { return datoFFTFifo.getNumAvailableForReading(); }
-    //==============================================================================
-    bool getFFTData(BlockType& datoFFT) { return datoFFTFifo.pull(datoFFT); }
+    //las bandas que no caben por debajo de Nyquist no se miden
+    bool estaDisponible(int banda) const { return bandas[(size_t)banda].disponible; }
 private:
-    FFTOrder order;
-    BlockType datoFFT;
-    std::unique_ptr<juce::dsp::FFT> forwardFFT;
-    std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+    static std::array<Coefficients, seccionesPorBanda> disenaBanda(double fInferior, double fSuperior, double sampleRate);
+
+    struct Banda
+    {
+        std::array<Filter, seccionesPorBanda> secciones;
+        float cuadraticoMedio = 0.f;
+        bool disponible = false;
+    };
+
+    struct Etapa
+    {
+        double frecuencia = 0.0;
+
+        //paso bajo antes del diezmado, a la frecuencia de la etapa anterior; la primera no lo usa
+        std::array<Filter, 4> antialias;
+        bool tomaEstaMuestra = false;
+
+        std::vector<int> bandas;
+        float coeficienteDetector = 1.f;
+    };
 
-    Fifo<BlockType> datoFFTFifo;
+    //los filtros no se copian, las etapas tienen sitio fijo y solo se usan las numEtapas primeras
+    std::array<Banda, numBandas> bandas;
+    std::array<Etapa, maxEtapas> etapas;
+    int numEtapas = 0;
+    std::vector<float> bufferEtapa;
+
+    double frecuenciaPreparada = 0.0;
+    float tiempoDeIntegracionMs = tiempoRapidoMs;
 };
 
-template<typename PathType>
-struct GeneradorDeSealParaAnalizador
+struct ProductorDeOndas : TrabajoDeAnalisis
 {
+    //el orden de la FFT y el diezmado se eligen en el hilo de analisis al conocer la frecuencia de muestreo
+    ProductorDeOndas(SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>& scsf,
+        SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>& scsfPreEcualizacion,
+        SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>& scsfReferencia) :
+        canalIzqFIFO(&scsf),
+        generacionLeida(scsf.getGeneracion()),
+        canalPreFIFO(&scsfPreEcualizacion),
+        generacionPreLeida(scsfPreEcualizacion.getGeneracion()),
+        canalReferenciaFIFO(&scsfReferencia),
+        generacionReferenciaLeida(scsfReferencia.getGeneracion())
+    {
+    }
+    //se llaman desde el hilo de mensajes
+    void setParametrosDeRender(juce::Rectangle<float> fftBounds,
+        double sampleRate,
+        const ConfiguracionAnalizador& configuracion);
+    void setActivo(bool debeAnalizar) { activo.store(debeAnalizar); }
+    void recogeSeal();
+    juce::Path getPath() { return sealFFTCanalIzq; }
+    juce::Path getPathPicos() { return sealPicos; }
+    juce::Path getPathPreEcualizacion() { return sealPreEcualizacion; }
+    juce::Path getPathReferencia() { return sealReferencia; }
+    juce::Path getPathDiferencia() { return sealDiferencia; }
+    const MedidaDeTransferencia& getMedidaDeTransferencia() const { return transferenciaParaDibujar; }
+    PicosEspectrales getPicosEspectrales() const { return picosParaDibujar; }
+    const NivelesDeTercios& getNivelesDeTercios() const { return terciosParaDibujar; }
+
+    //se llaman desde el PoolDeAnalisis
+    bool hayTrabajoPendiente() override;
+    void ejecuta() override;
+private:
+    void process(juce::Rectangle<float> fftBounds, double sampleRate, const ConfiguracionAnalizador& configuracion);
+
+    void preparaAnalisis(ModoAnalizador nuevoModo, double sampleRate);
+    static void aadeAlHistorial(juce::AudioBuffer<float>& historial, const float* muestras, int numMuestras);
+    void procesaMultiResolucion(int muestrasNuevas, juce::Rectangle<float> fftBounds, bool silencioso);
+    void publicaPicos(const float* datosDb, int numBins, float binWidth, float frecuenciaPrimerBin, float desde, float hasta);
+    void procesaReasignado(int muestrasNuevas, juce::Rectangle<float> fftBounds, bool silencioso);
+    void publicaSuelo(juce::Rectangle<float> fftBounds);
+    void procesaTrazaAdicional(SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>& canal,
+        DiezmadorPolifasico& diezmadorDeLaTraza,
+        juce::AudioBuffer<float>& historial,
+        int& muestrasEnSilencioDeLaTraza,
+        GeneradorDeDatosFFT<std::vector<float>>& generador);
+    void procesaReferencia(const std::vector<float>& datoSalida, juce::Rectangle<float> fftBounds, bool conDiferencia);
+    void reiniciaReferencia();
+    void procesaTransferencia(const juce::AudioBuffer<float>& salida, int numeroDelBuffer, juce::Rectangle<float> fftBounds, float alfa);
+    bool buscaEntradaDeTransferencia(int numeroDelBuffer);
+    void publicaTransferencia(juce::Rectangle<float> fftBounds);
+    void procesaTercios(const float* muestras, int numMuestras);
+    void descartaPendientes();
+    void reiniciaHistorial();
+
+    SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>* canalIzqFIFO;
+    int generacionLeida = 0;
+
     /*
-     converts 'renderData[]' into a juce::Path
+     pre-EQ overlay, normal mode only: the input before the filters gets its own decimator
+     and history, but its frames are transformed in the same call as the post-EQ ones with
+     the same FFT engine and window table.
      */
-    void generatePath(const std::vector<float>& renderData,
-        juce::Rectangle<float> fftBounds,
-        int fftSize,
-        float binWidth,
-        float negativeInfinity)
+    SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>* canalPreFIFO;
+    int generacionPreLeida = 0;
+    DiezmadorPolifasico diezmadorPre;
+    juce::AudioBuffer<float> historialPre;
+    int muestrasEnSilencioPre = 0;
+    GeneradorDeDatosFFT<std::vector<float>> generadorPreEcualizacion;
+
+    /*
+     reference track from the sidechain bus, normal mode only. same scheme as the pre-EQ
+     overlay, sharing its FFT engine and window table; it is not sample aligned with the
+     output, so a gap in its fifo only restarts its own history. the difference is the
+     output trace minus the reference, bin by bin after both are smoothed and averaged.
+     */
+    SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>* canalReferenciaFIFO;
+    int generacionReferenciaLeida = 0;
+    DiezmadorPolifasico diezmadorReferencia;
+    juce::AudioBuffer<float> historialReferencia;
+    int muestrasEnSilencioReferencia = 0;
+    GeneradorDeDatosFFT<std::vector<float>> generadorReferencia;
+    std::vector<float> datoReferencia, ultimaSalida, diferencia;
+
+    /*
+     above ~48 kHz the input is decimated before windowing, so the 20 Hz - 20 kHz
+     display does not waste bins and the bin width stays the same at any sample rate.
+     */
+    DiezmadorPolifasico diezmador;
+    juce::AudioBuffer<float> bloqueDiezmado;
+    double frecuenciaPreparada = 0.0, frecuenciaDeAnalisis = 0.0;
+
+    //historial compartido: las ultimas muestras (ya diezmadas) que necesita la FFT mas grande del modo actual
+    juce::AudioBuffer<float> monoBuffer;
+
+    /*
+     silence: consecutive decimated samples whose block peak (measured on the audio thread)
+     was below the display floor. once they cover the whole history, frames skip the FFT
+     and, when the averaging has settled, everything but a cached floor path.
+     */
+    int muestrasEnSilencio = 0;
+    juce::Rectangle<float> limitesDelSuelo;
+    std::vector<float> sueloPorColumna;
+    bool reasignadoEnSuelo = false;
+
+    GeneradorDeDatosFFT<std::vector<float>> generadorDatosFFTCanalIzq;
+
+    /*
+     multi-resolution: 16k points below 200 Hz, 4k up to 2 kHz and 1k above.
+     each band transforms every fftSize / 4 new samples.
+     */
+    struct BandaMultiResolucion
     {
-        auto top = fftBounds.getY();
-        auto bottom = fftBounds.getHeight();
-        auto width = fftBounds.getWidth();
+        GeneradorDeDatosFFT<std::vector<float>> generador;
+        std::vector<float> ultimoDato, ultimoPico;
+        int muestrasPendientes = 0;
+    };
 
-        int numBins = (int)fftSize / 2;
+    std::array<BandaMultiResolucion, 3> bandasMultiResolucion;
+    std::vector<BandaDeAnalisis> bandasParaDibujar;
+    bool bandasPreparadas = false;
 
-        PathType p;
-        p.preallocateSpace(3 * (int)fftBounds.getWidth());
+    AnalizadorZoom analizadorZoom;
+    std::vector<float> espectroZoom, picosZoom;
 
-        auto map = [bottom, top, negativeInfinity](float v)
-        {
-            return juce::jmap(v,
-                negativeInfinity, 0.f,
-                float(bottom + 10), top);
-        };
+    /*
+     reassigned: a 2048 point frame whose energy is scattered into pixel columns,
+     so the averaging and the peak hold work per column instead of per bin.
+     */
+    EspectroReasignado espectroReasignado;
+    MapaDeColumnas mapaReasignado;
+    PromediadorEspectral promediadorReasignado;
+    std::vector<float> columnasReasignadas, picosReasignados;
 
-        auto y = map(renderData[0]);
+    /*
+     transfer function: the pre-EQ history is the input and monoBuffer the output. both
+     decimators are reset together so their histories stay sample aligned, and the pair
+     goes through one complex FFT every half frame.
+     */
+    FuncionDeTransferencia funcionDeTransferencia;
+    juce::AudioBuffer<float> bloqueEntrada, bloqueEntradaDiezmado;
+    SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>::InfoDelBuffer infoBloqueEntrada;
+    bool hayBloqueEntrada = false;
+    MapaDeColumnas mapaTransferencia;
+    std::vector<float> columnasGxx, columnasGyy, columnasGxyRe, columnasGxyIm;
+    int muestrasPendientesTransferencia = 0;
+    Fifo<MedidaDeTransferencia> transferenciaFifo;
+    MedidaDeTransferencia medidaTransferencia, transferenciaParaDibujar;
 
-        //        jassert( !std::isnan(y) && !std::isinf(y) );
-        if (std::isnan(y) || std::isinf(y))
-            y = bottom;
+    /*
+     1/3 octave: the bank integrates per sample and its levels are read about 30 times
+     a second. the promediador only adds the frame based averaging modes and the peak hold.
+     */
+    static constexpr int tramasDeTerciosPorSegundo = 30;
+    BancoDeTercios bancoDeTercios;
+    PromediadorEspectral promediadorTercios;
+    std::array<float, NivelesDeTercios::numBandas> potenciasTercios{};
+    int muestrasPendientesTercios = 0;
+    Fifo<NivelesDeTercios> terciosFifo;
+    NivelesDeTercios nivelesDeTercios, terciosParaDibujar;
 
-        p.startNewSubPath(0, y);
+    ModoAnalizador modo = ModoAnalizador::Modo_Normal;
 
-        const int pathResolution = 2; //you can draw line-to's every 'pathResolution' pixels.
+    //la traza de picos se genera igual que la normal pero con su propio fifo de paths
+    GeneradorDeSealParaAnalizador<juce::Path> productorDeSeal, productorDePicos, productorPreEcualizacion;
+    GeneradorDeSealParaAnalizador<juce::Path> productorReferencia, productorDiferencia;
 
-        for (int binNum = 1; binNum < numBins; binNum += pathResolution)
-        {
-            y = map(renderData[binNum]);
+    juce::Path sealFFTCanalIzq, sealPicos, sealPreEcualizacion, sealReferencia, sealDiferencia;
 
-            //            jassert( !std::isnan(y) && !std::isinf(y) );
+    //los picos marcados viajan con el mismo esquema que los paths: fifo en el analisis, copia en el hilo de mensajes
+    DetectorDePicos detectorDePicos;
+    Fifo<PicosEspectrales> picosFifo;
+    PicosEspectrales picosParaDibujar;
 
-            if (!std::isnan(y) && !std::isinf(y))
-            {
-                auto binFreq = binNum * binWidth;
-                auto normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
-                int binX = std::floor(normalizedBinX * width);
-                p.lineTo(binX, y);
-            }
-        }
+    std::atomic<bool> activo{ false };
 
-        pathFifo.push(p);
-    }
+    juce::SpinLock lockParametros;
+    juce::Rectangle<float> limitesFFT;
+    double frecuenciaMuestreo = 0.0;
+    ConfiguracionAnalizador configuracionAnalizador;
+};
 
-    int getNumPathsAvailable() const
+/*
+ base of the jobs that work on something the processor hands over once, in a few steps:
+ they wait until it can be copied, process it a bit per call so the live producers keep
+ getting their turn, and publish the result. once finished they only redraw when the
+ drawing area or the axis change. every empieza() or cancela() restarts the sequence.
+ */
+struct MedidaEnSegundoPlano : TrabajoDeAnalisis
+{
+    //se llaman desde el hilo de mensajes
+    void empieza();
+    void cancela();
+    void setParametrosDeRender(juce::Rectangle<float> fftBounds, const EjeDeFrecuencias& eje);
+
+    bool estaActivo() const { return activo.load(); }
+
+    //se llaman desde el PoolDeAnalisis
+    bool hayTrabajoPendiente() override;
+    void ejecuta() override;
+protected:
+    enum class Copia
     {
-        return pathFifo.getNumAvailableForReading();
-    }
+        Esperando,
+        SinDatos,
+        Copiada
+    };
 
-    bool getPath(PathType& path)
+    //en el hilo de mensajes, al principio de empieza() y al final de cancela()
+    virtual void alEmpezar() { }
+    virtual void alCancelar() { }
+
+    //barato, con el lock del pool tomado: si intentaCopiar() puede tener exito
+    virtual bool hayAlgoQueCopiar() = 0;
+
+    //copia lo del procesador y deja todo listo para avanza()
+    virtual Copia intentaCopiar() = 0;
+
+    //un paso del trabajo; true cuando ya esta el resultado
+    virtual bool avanza() = 0;
+
+    //solo se llama con resultado
+    virtual void publica() = 0;
+
+    void getParametrosDeRender(juce::Rectangle<float>& fftBounds, EjeDeFrecuencias& eje);
+private:
+    std::atomic<bool> activo{ false };
+
+    //cada empieza() y cancela() la cambia, el hilo de analisis vuelve a empezar al verlo
+    std::atomic<int> peticion{ 0 };
+    int peticionAtendida = 0;
+
+    enum class Fase
     {
-        return pathFifo.pull(path);
-    }
+        Copiando,
+        Procesando,
+        Terminado
+    };
+
+    Fase fase = Fase::Terminado;
+    bool hayResultado = false;
+
+    juce::SpinLock lockParametros;
+    juce::Rectangle<float> limitesFFT;
+    EjeDeFrecuencias ejeDeDibujo;
+    std::atomic<bool> redibujar{ false };
+};
+
+/*
+ re-analysis of the frozen capture: Welch average of 65536 point Blackman-Harris frames
+ with 75% overlap over everything it holds, for both channels, a few frames per call.
+ */
+struct ReanalisisCongelado : MedidaEnSegundoPlano
+{
+    explicit ReanalisisCongelado(CapturaRetroactiva& c) : captura(c) { }
+
+    //se llama desde el hilo de mensajes
+    void recogeSeal();
+
+    juce::Path getPath(Channel canal) const { return seales[(size_t)canal]; }
+
+    //0..1 mientras analiza, 1 al terminar
+    float getProgreso() const { return progreso.load(); }
+    double getSegundosAnalizados() const { return segundosAnalizados.load(); }
+
+    static constexpr int ordenFFT = 16;
+    static constexpr int framesPorLlamada = 4;
 private:
-    Fifo<PathType> pathFifo;
+    void alEmpezar() override;
+    void alCancelar() override;
+    bool hayAlgoQueCopiar() override { return captura.estaDetenida(); }
+    Copia intentaCopiar() override;
+    bool avanza() override;
+    void publica() override;
+
+    bool preparaAnalisis();
+
+    CapturaRetroactiva& captura;
+
+    juce::AudioBuffer<float> muestras;
+    double frecuenciaCapturada = 0.0;
+    int framesHechos = 0, numFrames = 0;
+
+    std::unique_ptr<MotorFFT> motor;
+    std::unique_ptr<juce::dsp::WindowingFunction<float>> ventana;
+    std::vector<float> datos;
+    std::array<std::vector<float>, 2> espectros;
+
+    std::array<GeneradorDeSealParaAnalizador<juce::Path>, 2> productores;
+    std::array<juce::Path, 2> seales;
+
+    std::atomic<float> progreso{ 0.f };
+    std::atomic<double> segundosAnalizados{ 0.0 };
 };
 
-struct LookAndFeel : juce::LookAndFeel_V4
+/*
+ deconvolution of a sweep measurement. it waits until the processor holds the whole
+ recording, then deconvolves one channel per call (a 2^18 point FFT each) and publishes
+ the magnitude of the windowed impulse response per pixel column.
+ */
+struct MedidaConBarrido : MedidaEnSegundoPlano
 {
-    void drawRotarySlider(juce::Graphics&,
-        int x, int y, int width, int height,
-        float sliderPosProportional,
-        float rotaryStartAngle,
-        float rotaryEndAngle,
-        juce::Slider&) override;
+    explicit MedidaConBarrido(BarridoSinusoidal& b) : barrido(b) { }
 
-    void drawToggleButton(juce::Graphics& g,
-        juce::ToggleButton& toggleButton,
-        bool shouldDrawButtonAsHighlighted,
-        bool shouldDrawButtonAsDown) override;
+    //se llama desde el hilo de mensajes
+    void recogeSeal();
+
+    bool estaDeconvolucionando() const { return deconvolucionando.load(); }
+    bool hayMedida() const { return !medidaParaDibujar.respuestaDb[0].empty(); }
+    const MedidaDelBarrido& getMedida() const { return medidaParaDibujar; }
+
+    //lo que se ensea del impulso: desde 1 ms antes del pico hasta 20 ms despues
+    static constexpr float msAntesDelPico = 1.f;
+    static constexpr float msDespuesDelPico = 20.f;
+private:
+    void alCancelar() override;
+    bool hayAlgoQueCopiar() override { return barrido.hayGrabacion(); }
+    Copia intentaCopiar() override;
+    bool avanza() override;
+    void publica() override;
+
+    BarridoSinusoidal& barrido;
+
+    std::atomic<bool> deconvolucionando{ false };
+
+    juce::AudioBuffer<float> grabacion;
+    double frecuenciaGrabada = 0.0;
+    int canalesHechos = 0;
+
+    DeconvolucionDeBarrido deconvolucion;
+    std::unique_ptr<MotorFFT> motor;
+    std::vector<float> datos, unos, columnasCuenta, columnasPotencia;
+    std::array<std::vector<float>, 2> impulsos, potencias;
+    MapaDeColumnas mapa;
+
+    Fifo<MedidaDelBarrido> medidaFifo;
+    MedidaDelBarrido medida, medidaParaDibujar;
 };
 
-struct SliderRotatorioConEtiquetas : juce::Slider
+/*
+ distortion analysis of the test tone. it keeps the last 65536 samples of what comes back
+ in a ring and analyzes them every muestrasEntreAnalisis new ones, about six times per
+ second at 48 kHz, behind the live producers.
+ */
+struct AnalisisDeDistorsion : TrabajoDeAnalisis
 {
-    SliderRotatorioConEtiquetas(juce::RangedAudioParameter& rap, const juce::String& unitSuffix) :
-        juce::Slider(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag,
-            juce::Slider::TextEntryBoxPosition::NoTextBox),
-        param(&rap),
-        suffix(unitSuffix)
+    explicit AnalisisDeDistorsion(SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>& scsf) :
+        canalFIFO(&scsf),
+        generacionLeida(scsf.getGeneracion())
     {
-        setLookAndFeel(&lnf);
     }
 
-    ~SliderRotatorioConEtiquetas()
+    //se llaman desde el hilo de mensajes
+    void setActivo(bool activar) { activo.store(activar); }
+    bool estaActivo() const { return activo.load(); }
+    void setFrecuenciaDeMuestreo(double sampleRate) { frecuenciaMuestreo.store(sampleRate); }
+
+    void recogeResultado();
+    const ResultadoDeDistorsion& getResultado() const { return resultadoParaDibujar; }
+
+    //se llaman desde el PoolDeAnalisis
+    bool hayTrabajoPendiente() override;
+    void ejecuta() override;
+
+    static constexpr int muestrasEntreAnalisis = 8192;
+private:
+    SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>* canalFIFO;
+    int generacionLeida = 0;
+
+    std::atomic<bool> activo{ false };
+    std::atomic<double> frecuenciaMuestreo{ 0.0 };
+
+    juce::AudioBuffer<float> bloque;
+
+    //anillo con lo ultimo recibido y la trama ordenada que se analiza
+    std::vector<float> anillo, trama;
+    int posicionEscritura = 0, muestrasValidas = 0, muestrasNuevas = 0;
+
+    AnalizadorDeDistorsion analizador;
+
+    Fifo<ResultadoDeDistorsion> resultadoFifo;
+    ResultadoDeDistorsion resultadoParaDibujar;
+};
+
+/*
+ the last samples of two fifos that are resumed together. their buffers are paired by
+ number and a buffer whose partner did not fit in the other fifo is dropped, so both
+ rings always hold the same stretch of time.
+ */
+struct ParDeCanales
+{
+    using Canal = SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>;
+
+    ParDeCanales(Canal& izq, Canal& der) :
+        canalIzq(&izq),
+        canalDer(&der),
+        generacionIzqLeida(izq.getGeneracion()),
+        generacionDerLeida(der.getGeneracion())
     {
-        setLookAndFeel(nullptr);
     }
 
-    struct PosicionEtiqueta
+    bool hayBloquesPendientes() const
     {
-        float pos;
-        juce::String etiqueta;
-    };
+        return canalIzq->getNumCompleteBuffersAvailable() > 0 || canalDer->getNumCompleteBuffersAvailable() > 0;
+    }
 
-    juce::Array<PosicionEtiqueta> etiquetas;
+    //si alguno de los fifos se reanudo, lo que queda en cola es de antes del hueco: se tira y los anillos se vacian
+    bool compruebaGeneracion();
+    void descartaPendientes();
 
-    void paint(juce::Graphics& g) override;
-    juce::Rectangle<int> getSliderBounds() const;
-    int getTextHeight() const { return 14; }
-    juce::String getDisplayString() const;
+    //anillos de 'tamao' muestras, solo reserva memoria si cambia
+    void prepara(int tamao);
+    void vacia();
+
+    //aade a los anillos el siguiente par de bloques, false cuando falta alguno
+    bool aadeSiguientePar();
+
+    int getMuestrasValidas() const { return muestrasValidas; }
+    int getMuestrasNuevas() const { return muestrasNuevas; }
+    void descuentaMuestrasNuevas(int numMuestras) { muestrasNuevas = juce::jmax(0, muestrasNuevas - numMuestras); }
+
+    //las ultimas 'numMuestras' de cada canal, de la mas antigua a la mas reciente
+    void copiaUltimas(float* izq, float* der, int numMuestras) const;
 private:
-    LookAndFeel lnf;
+    bool emparejaBloques();
 
-    juce::RangedAudioParameter* param;
-    juce::String suffix;
+    Canal* canalIzq;
+    Canal* canalDer;
+    int generacionIzqLeida = 0, generacionDerLeida = 0;
+
+    //el ultimo bloque de cada lado que aun no tiene pareja
+    juce::AudioBuffer<float> bloqueIzq, bloqueDer;
+    Canal::InfoDelBuffer infoIzq, infoDer;
+    bool hayBloqueIzq = false, hayBloqueDer = false;
+
+    std::vector<float> anilloIzq, anilloDer;
+    int posicionEscritura = 0, muestrasValidas = 0, muestrasNuevas = 0;
 };
 
-struct ProductorDeOndas
+/*
+ stereo view of the output: mid and side spectra, or correlation and coherence between
+ left and right. it reads its own pair of fifos, fed only while the view is on, so both
+ channels of every frame come from the same blocks. frames of 8192 points with 50%
+ overlap, averaged like the live trace.
+
+ the live producers' spectra can't be reused: each channel runs in its own job, on its
+ own decimated signal with a size that depends on the mode and the sample rate, and only
+ the power is kept. while the view is on this costs two more fifo copies per block on the
+ audio thread and one 8192 point complex FFT per 4096 samples here.
+ */
+struct AnalisisEstereo : TrabajoDeAnalisis
 {
-    ProductorDeOndas(SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>& scsf) :
-        canalIzqFIFO(&scsf)
-    {
-        generadorDatosFFTCanalIzq.changeOrder(FFTOrder::order2048);
-        monoBuffer.setSize(1, generadorDatosFFTCanalIzq.getFFTSize());
-    }
-    void process(juce::Rectangle<float> fftBounds, double sampleRate);
-    juce::Path getPath() { return sealFFTCanalIzq; }
+    AnalisisEstereo(ParDeCanales::Canal& izq, ParDeCanales::Canal& der) : par(izq, der) { }
+
+    //se llaman desde el hilo de mensajes
+    void setParametrosDeRender(juce::Rectangle<float> fftBounds,
+        double sampleRate,
+        const ConfiguracionAnalizador& configuracion,
+        const EjeDeFrecuencias& eje);
+    void setActivo(bool activar) { activo.store(activar); }
+    void recogeSeal();
+
+    juce::Path getPathMedio() const { return sealMedio; }
+    juce::Path getPathLado() const { return sealLado; }
+    const MedidaEstereo& getMedida() const { return medidaParaDibujar; }
+
+    //se llaman desde el PoolDeAnalisis
+    bool hayTrabajoPendiente() override;
+    void ejecuta() override;
+
+    static constexpr int ordenFFT = FFTOrder::order8192;
 private:
-    SingleChannelSampleFifo<MonitorDeEspectroDeSealAudioProcessor::BlockType>* canalIzqFIFO;
+    void publica(juce::Rectangle<float> fftBounds, double sampleRate, VistaEstereo vista, const EjeDeFrecuencias& eje);
 
-    juce::AudioBuffer<float> monoBuffer;
+    ParDeCanales par;
 
-    GeneradorDeDatosFFT<std::vector<float>> generadorDatosFFTCanalIzq;
+    std::atomic<bool> activo{ false };
+
+    //las tramas ordenadas que se analizan
+    std::vector<float> tramaIzq, tramaDer;
+
+    AnalizadorEstereo analizador;
+    std::vector<float> espectroMedio, espectroLado;
+    GeneradorDeSealParaAnalizador<juce::Path> productorMedio, productorLado;
+    juce::Path sealMedio, sealLado;
+
+    MapaDeColumnas mapa;
+    std::vector<float> columnasLl, columnasRr, columnasLrRe, columnasLrIm;
+
+    Fifo<MedidaEstereo> medidaFifo;
+    MedidaEstereo medida, medidaParaDibujar;
+
+    juce::SpinLock lockParametros;
+    juce::Rectangle<float> limitesFFT;
+    double frecuenciaMuestreo = 0.0;
+    ConfiguracionAnalizador configuracionAnalizador;
+    EjeDeFrecuencias ejeDeDibujo;
+};
+
+/*
+ delay between the input channels, for lining up a pair of microphones. it keeps the
+ last 65536 samples of both in a ring and runs GCC-PHAT over the selected window a few
+ times per second, behind the live producers. every buffer is reserved up front, the
+ estimator only reallocates when the window changes.
+ */
+struct AnalisisDeRetardo : TrabajoDeAnalisis
+{
+    AnalisisDeRetardo(ParDeCanales::Canal& izq, ParDeCanales::Canal& der) : par(izq, der) { }
+
+    //se llaman desde el hilo de mensajes; una ventana de orden 0 apaga la estimacion
+    void setOrdenVentana(int orden) { ordenVentana.store(orden); }
+    bool estaActivo() const { return ordenVentana.load() > 0; }
+    void setFrecuenciaDeMuestreo(double sampleRate) { frecuenciaMuestreo.store(sampleRate); }
+
+    void recogeResultado();
+    const ResultadoDeRetardo& getResultado() const { return resultadoParaDibujar; }
 
-    GeneradorDeSealParaAnalizador<juce::Path> productorDeSeal;
+    //se llaman desde el PoolDeAnalisis
+    bool hayTrabajoPendiente() override;
+    void ejecuta() override;
 
-    juce::Path sealFFTCanalIzq;
+    static constexpr int ordenMaximo = 16;
+    static constexpr int estimacionesPorSegundo = 4;
+private:
+    ParDeCanales par;
+
+    std::atomic<int> ordenVentana{ 0 };
+    std::atomic<double> frecuenciaMuestreo{ 0.0 };
+
+    EstimadorDeRetardo estimador;
+    std::vector<float> ventanaIzq, ventanaDer;
+
+    Fifo<ResultadoDeRetardo> resultadoFifo;
+    ResultadoDeRetardo resultadoParaDibujar;
+};
+
+/*
+ level statistics of the output over a long take, per bin: P10, P50 and P90 and a noise
+ floor estimate (see EstadisticaEspectral.h). it analyses the mid signal, (L + R) / 2, from
+ its own pair of fifos, behind the live producers, and publishes the curves a few times per
+ second. a gap in the fifos (the statistics or the analyzer switched off) starts over.
+ */
+struct AnalisisEstadistico : TrabajoDeAnalisis
+{
+    AnalisisEstadistico(ParDeCanales::Canal& izq, ParDeCanales::Canal& der) : par(izq, der) { }
+
+    //se llaman desde el hilo de mensajes
+    void setParametrosDeRender(juce::Rectangle<float> fftBounds, double sampleRate, const EjeDeFrecuencias& eje);
+    void setActivo(bool activar) { activo.store(activar); }
+    bool estaActivo() const { return activo.load(); }
+    void recogeSeal();
+
+    juce::Path getPathPercentil(int percentil) const { return sealesPercentiles[(size_t)percentil]; }
+    juce::Path getPathSuelo() const { return sealSuelo; }
+    double getSegundosAnalizados() const { return segundosAnalizados.load(); }
+
+    //se llaman desde el PoolDeAnalisis
+    bool hayTrabajoPendiente() override;
+    void ejecuta() override;
+
+    static constexpr int publicacionesPorSegundo = 4;
+private:
+    void publica(juce::Rectangle<float> fftBounds, double sampleRate, const EjeDeFrecuencias& eje);
+
+    ParDeCanales par;
+
+    std::atomic<bool> activo{ false };
+    std::atomic<double> segundosAnalizados{ 0.0 };
+
+    EstadisticaEspectral estadistica;
+    double frecuenciaPreparada = 0.0;
+    int muestrasSinPublicar = 0;
+
+    std::vector<float> tramaIzq, tramaDer;
+
+    std::array<std::vector<float>, EstadisticaEspectral::numPercentiles> percentiles;
+    std::vector<float> suelo;
+
+    std::array<GeneradorDeSealParaAnalizador<juce::Path>, EstadisticaEspectral::numPercentiles> productoresPercentiles;
+    GeneradorDeSealParaAnalizador<juce::Path> productorSuelo;
+    std::array<juce::Path, EstadisticaEspectral::numPercentiles> sealesPercentiles;
+    juce::Path sealSuelo;
+
+    juce::SpinLock lockParametros;
+    juce::Rectangle<float> limitesFFT;
+    double frecuenciaMuestreo = 0.0;
+    EjeDeFrecuencias ejeDeDibujo;
 };
 
 struct ComponenteAnalizador : juce::Component,
@@ -253,10 +1689,28 @@ struct ComponenteAnalizador : juce::Component,
     void paint(juce::Graphics& g) override;
     void resized() override;
 
+    /*
+     dragging over the analyzer picks the zoom band, a double click goes back to the normal
+     view. a right click adds a tracked tone there, or removes the one under the mouse.
+     */
+    void mouseDown(const juce::MouseEvent& e) override;
+    void mouseDrag(const juce::MouseEvent& e) override;
+    void mouseUp(const juce::MouseEvent& e) override;
+    void mouseDoubleClick(const juce::MouseEvent& e) override;
+
     void toggleAnalysisEnablement(bool enabled)
     {
         shouldShowFFTAnalysis = enabled;
     }
+
+    //congela la captura retroactiva y la reanaliza en segundo plano, el analisis en vivo sigue igual
+    void setCongelado(bool congelar);
+
+    //lanza una medida con barrido hacia el destino elegido, o la cancela y deja de dibujarla
+    void setBarrido(bool medir);
+
+    //hace sonar el tono de prueba y mide su distorsion, o lo para
+    void setDistorsion(bool medir);
 private:
     MonitorDeEspectroDeSealAudioProcessor& audioProcessor;
 
@@ -274,6 +1728,16 @@ private:
 
     void drawBackgroundGrid(juce::Graphics& g);
     void drawTextLabels(juce::Graphics& g);
+    void dibujaPicosMarcados(juce::Graphics& g, juce::Rectangle<int> responseArea);
+    void dibujaCongelado(juce::Graphics& g, juce::Rectangle<int> responseArea);
+    void dibujaBarrido(juce::Graphics& g, juce::Rectangle<int> responseArea);
+    void dibujaDistorsion(juce::Graphics& g, juce::Rectangle<int> responseArea);
+    void dibujaEstereo(juce::Graphics& g, juce::Rectangle<int> responseArea);
+    void dibujaRetardo(juce::Graphics& g, juce::Rectangle<int> responseArea);
+    void dibujaSonoridad(juce::Graphics& g, juce::Rectangle<int> responseArea);
+    void dibujaTonos(juce::Graphics& g, juce::Rectangle<int> responseArea);
+    void dibujaEstadistica(juce::Graphics& g, juce::Rectangle<int> responseArea);
+    void dibujaReferencia(juce::Graphics& g, juce::Rectangle<int> responseArea);
 
     std::vector<float> getFrequencies();
     std::vector<float> getGains();
@@ -284,6 +1748,29 @@ private:
     juce::Rectangle<int> getAnalysisArea();
 
     ProductorDeOndas productorOndaIzq, productorOndaDer;
+    ReanalisisCongelado reanalisisCongelado;
+    MedidaConBarrido medidaConBarrido;
+    AnalisisDeDistorsion analisisDeDistorsion;
+    AnalisisEstereo analisisEstereo;
+    AnalisisDeRetardo analisisDeRetardo;
+    AnalisisEstadistico analisisEstadistico;
+
+    void actualizaTrabajosDeAnalisis();
+
+    EjeDeFrecuencias eje;
+    bool mostrarPicos = false, mostrarPreEcualizacion = false, mostrarSonoridad = false, mostrarTonos = false;
+    ModoAnalizador modoAnalizador = ModoAnalizador::Modo_Normal;
+    VistaEstereo vistaEstereo = VistaEstereo::Estereo_Apagado;
+    VistaReferencia vistaReferencia = VistaReferencia::Referencia_Apagada;
+
+    void dibujaTransferencia(juce::Graphics& g, juce::Rectangle<int> responseArea);
+    void dibujaTercios(juce::Graphics& g, juce::Rectangle<int> responseArea);
+
+    juce::Range<int> seleccionZoom;
+    bool seleccionandoZoom = false;
+
+    void setParametro(const juce::String& id, float valor);
+    void alternaTonoDeUsuario(int x);
 };
 //==============================================================================
 struct BotonEncendido : juce::ToggleButton { };
@@ -339,6 +1826,8 @@ private:
 
     ComponenteAnalizador componenteAnalizador;
 
+    SelectorDeOpcion selectorSuavizado, selectorModo, selectorPromediado, selectorMarcas, selectorDestinoBarrido, selectorEstereo, selectorRetardo, selectorTonos, selectorReferencia;
+
     using APVTS = juce::AudioProcessorValueTreeState;
     using Attachment = APVTS::SliderAttachment;
 
@@ -354,13 +1843,30 @@ private:
 
     BotonEncendido botonBypassBajo, botonBypassPico, botonBypassAlto;
     BotonAnalizador botonAnalizadorHabilitado;
+    juce::ToggleButton botonRetenerPicos, botonCongelar, botonPreEcualizacion, botonBarrido, botonDistorsion, botonSonoridad, botonEstadistica;
 
     using ButtonAttachment = APVTS::ButtonAttachment;
 
     ButtonAttachment AttachmentBypassBotonBajo,
         AttachmentBotonBypassPico,
         AttachmentBotonBypassAlto,
-        AttachmentBotonAnalizadorHabilitado;
+        AttachmentBotonAnalizadorHabilitado,
+        AttachmentBotonRetenerPicos,
+        AttachmentBotonPreEcualizacion,
+        AttachmentBotonSonoridad,
+        AttachmentBotonEstadistica;
+
+    using ComboBoxAttachment = APVTS::ComboBoxAttachment;
+
+    ComboBoxAttachment AttachmentSelectorSuavizado,
+        AttachmentSelectorModo,
+        AttachmentSelectorPromediado,
+        AttachmentSelectorMarcas,
+        AttachmentSelectorDestinoBarrido,
+        AttachmentSelectorEstereo,
+        AttachmentSelectorRetardo,
+        AttachmentSelectorTonos,
+        AttachmentSelectorReferencia;
 
     LookAndFeel lnf;
 
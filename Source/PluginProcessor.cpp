@@ -16,6 +16,7 @@ MonitorDeEspectroDeSe
 #if ! JucePlugin_IsMidiEffect
 #if ! JucePlugin_IsSynth
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
+        .withInput("Referencia", juce::AudioChannelSet::stereo(), false)
 #endif
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
@@ -109,14 +110,39 @@ void MonitorDeEspectroDeSe
 
     actualizaFiltros();
 
+    //los coeficientes antes del reset, asi el estado de los filtros se reserva aqui y no en el hilo de audio
+    auto ponderacion = generadorPonderacionK(sampleRate);
+
+    for (auto* cadenaPonderacion : { &ponderacionIzq, &ponderacionDer })
+    {
+        cadenaPonderacion->prepare(spec);
+        updateCoefficients(cadenaPonderacion->get<0>().coefficients, ponderacion[0]);
+        updateCoefficients(cadenaPonderacion->get<1>().coefficients, ponderacion[1]);
+        cadenaPonderacion->reset();
+    }
+
+    bufferPonderado.setSize(MedidorDeSonoridad::numCanales, samplesPerBlock, false, true, true);
+    medidorDeSonoridad.prepare(sampleRate);
+    rastreadorDeTonos.prepare(sampleRate);
+
     canalIzqFIFO.prepare(samplesPerBlock);
     canalDerFIFO.prepare(samplesPerBlock);
-
-    osc.initialise([](float x) { return std::sin(x); });
+    canalIzqPreFIFO.prepare(samplesPerBlock);
+    canalDerPreFIFO.prepare(samplesPerBlock);
+    canalIzqEstereoFIFO.prepare(samplesPerBlock);
+    canalDerEstereoFIFO.prepare(samplesPerBlock);
+    canalIzqRetardoFIFO.prepare(samplesPerBlock);
+    canalDerRetardoFIFO.prepare(samplesPerBlock);
+    canalIzqEstadisticaFIFO.prepare(samplesPerBlock);
+    canalDerEstadisticaFIFO.prepare(samplesPerBlock);
+    canalIzqReferenciaFIFO.prepare(samplesPerBlock);
+    canalDerReferenciaFIFO.prepare(samplesPerBlock);
+    canalDistorsionFIFO.prepare(samplesPerBlock);
+
+    capturaRetroactiva.prepare(sampleRate, getTotalNumOutputChannels());
 
     spec.numChannels = getTotalNumOutputChannels();
-    osc.prepare(spec);
-    osc.setFrequency(440);
+    barridoSinusoidal.prepare(spec);
 }
 
 void MonitorDeEspectroDeSealAudioProcessor::releaseResources()
@@ -144,6 +170,17 @@ bool MonitorDeEspectroDeSe
 #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    //la referencia puede estar desactivada, o ser mono o estereo
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto referencia = layouts.getChannelSet(true, 1);
+
+        if (!referencia.isDisabled()
+            && referencia != juce::AudioChannelSet::mono()
+            && referencia != juce::AudioChannelSet::stereo())
+            return false;
+    }
 #endif
 
     return true;
@@ -151,7 +188,7 @@ bool MonitorDeEspectroDeSe
 }
 #endif
 
-void MonitorDeEspectroDeSealAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+void MonitorDeEspectroDeSealAudioProcessor::processBlock(juce::AudioBuffer<float>& bufferDelHost, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
@@ -164,21 +201,124 @@ void MonitorDeEspectroDeSe
     // when they first compile a plugin, but obviously you don't need to keep
     // this code if your algorithm always overwrites all the output channels.
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear(i, 0, buffer.getNumSamples());
+        bufferDelHost.clear(i, 0, bufferDelHost.getNumSamples());
+
+    //el host junta en un buffer el bus principal y, detras, la referencia; todo lo demas ve solo el principal
+    auto buffer = getBusBuffer(bufferDelHost, false, 0);
+    auto referencia = getBusBuffer(bufferDelHost, true, 1);
 
     actualizaFiltros();
 
-    juce::dsp::AudioBlock<float> block(buffer);
+    //durante una medida el barrido sustituye a la entrada (o se graba lo que vuelve del equipo externo)
+    barridoSinusoidal.antesDeLaCadena(buffer);
+
+    //con un equipo externo lo que vuelve del tono es la entrada, antes de los filtros
+    auto tonoHaciaFuera = barridoSinusoidal.tonoSonando(Barrido_Externo);
+    auto tonoPorLaCadena = barridoSinusoidal.tonoSonando(Barrido_Cadena);
+
+    if ((tonoHaciaFuera || tonoPorLaCadena) && !distorsionAlimentada)
+        canalDistorsionFIFO.reanuda();
+
+    distorsionAlimentada = tonoHaciaFuera || tonoPorLaCadena;
+
+    if (tonoHaciaFuera)
+        canalDistorsionFIFO.update(buffer);
+
+    //sin editor o con el analizador apagado nadie va a leer los fifos, no los llenamos
+    auto alimentaAnalizador = consumidoresDelAnalizador.load() > 0
+        && apvts.getRawParameterValue("Analizador Activado")->load() > 0.5f;
+
+    //la funcion de transferencia tambien necesita la entrada sin ecualizar
+    auto alimentaPreEcualizacion = alimentaAnalizador
+        && (apvts.getRawParameterValue("Mostrar Pre EQ")->load() > 0.5f
+            || (int)apvts.getRawParameterValue("Modo Analizador")->load() == ModoAnalizador::Modo_Transferencia);
+
+    /*
+     los cuatro fifos se reanudan juntos, asi sus buffers empiezan en la misma muestra y
+     cada bloque de la entrada se puede emparejar con el de la salida.
+     */
+    if ((alimentaAnalizador && !analizadorAlimentado) || (alimentaPreEcualizacion && !preEcualizacionAlimentada))
+    {
+        canalIzqFIFO.reanuda();
+        canalDerFIFO.reanuda();
+        canalIzqPreFIFO.reanuda();
+        canalDerPreFIFO.reanuda();
+    }
+
+    //la traza pre EQ se toma aqui, antes de que los filtros toquen el buffer
+    if (alimentaPreEcualizacion)
+    {
+        canalIzqPreFIFO.update(buffer);
+        canalDerPreFIFO.update(buffer);
+    }
+
+    preEcualizacionAlimentada = alimentaPreEcualizacion;
+
+    auto alimentaEstereo = alimentaAnalizador
+        && (int)apvts.getRawParameterValue("Vista Estereo")->load() != VistaEstereo::Estereo_Apagado;
+
+    //los dos a la vez, asi sus buffers se emparejan por numero
+    if (alimentaEstereo && !estereoAlimentado)
+    {
+        canalIzqEstereoFIFO.reanuda();
+        canalDerEstereoFIFO.reanuda();
+    }
+
+    estereoAlimentado = alimentaEstereo;
+
+    auto alimentaEstadistica = alimentaAnalizador
+        && apvts.getRawParameterValue("Estadistica Espectral")->load() > 0.5f;
+
+    if (alimentaEstadistica && !estadisticaAlimentada)
+    {
+        canalIzqEstadisticaFIFO.reanuda();
+        canalDerEstadisticaFIFO.reanuda();
+    }
 
-    //    buffer.clear();
-    //
-    //    for( int i = 0; i < buffer.getNumSamples(); ++i )
-    //    {
-    //        buffer.setSample(0, i, osc.processSample(0));
-    //    }
-    //
-    //    juce::dsp::ProcessContextReplacing<float> stereoContext(block);
-    //    osc.process(stereoContext);
+    estadisticaAlimentada = alimentaEstadistica;
+
+    //la referencia solo se analiza: no pasa por los filtros ni llega a la salida
+    auto alimentaReferencia = alimentaAnalizador
+        && referencia.getNumChannels() > 0
+        && (int)apvts.getRawParameterValue("Vista Referencia")->load() != VistaReferencia::Referencia_Apagada;
+
+    if (alimentaReferencia && !referenciaAlimentada)
+    {
+        canalIzqReferenciaFIFO.reanuda();
+        canalDerReferenciaFIFO.reanuda();
+    }
+
+    if (alimentaReferencia)
+    {
+        //una referencia mono va igual a los dos lados
+        std::array<float*, 2> canales{ referencia.getWritePointer(0), referencia.getWritePointer(referencia.getNumChannels() - 1) };
+        juce::AudioBuffer<float> referenciaEstereo(canales.data(), 2, referencia.getNumSamples());
+
+        canalIzqReferenciaFIFO.update(referenciaEstereo);
+        canalDerReferenciaFIFO.update(referenciaEstereo);
+    }
+
+    referenciaAlimentada = alimentaReferencia;
+
+    //el retardo entre microfonos se mide en la entrada; los filtros son iguales en los dos canales
+    auto alimentaRetardo = alimentaAnalizador
+        && (int)apvts.getRawParameterValue("Ventana Retardo")->load() > 0;
+
+    if (alimentaRetardo && !retardoAlimentado)
+    {
+        canalIzqRetardoFIFO.reanuda();
+        canalDerRetardoFIFO.reanuda();
+    }
+
+    if (alimentaRetardo)
+    {
+        canalIzqRetardoFIFO.update(buffer);
+        canalDerRetardoFIFO.update(buffer);
+    }
+
+    retardoAlimentado = alimentaRetardo;
+
+    juce::dsp::AudioBlock<float> block(buffer);
 
     auto leftBlock = block.getSingleChannelBlock(0);
     auto rightBlock = block.getSingleChannelBlock(1);
@@ -189,9 +329,64 @@ void MonitorDeEspectroDeSe
     cadenaIzq.process(leftContext);
     cadenaDer.process(rightContext);
 
-    canalIzqFIFO.update(buffer);
-    canalDerFIFO.update(buffer);
+    if (tonoPorLaCadena)
+        canalDistorsionFIFO.update(buffer);
+
+    //los tonos solo se leen en el editor; sus niveles quedan al dia al final de cada bloque
+    std::array<float, RastreadorDeTonos::maxTonos> frecuenciasRastreadas;
+    auto numTonos = consumidoresDelAnalizador.load() > 0 ? getTonosRastreados(apvts, frecuenciasRastreadas) : 0;
+
+    if (numTonos > 0)
+    {
+        rastreadorDeTonos.setFrecuencias(frecuenciasRastreadas.data(), numTonos);
+
+        if (!tonosRastreados)
+            rastreadorDeTonos.reinicia();
+
+        rastreadorDeTonos.process(buffer);
+    }
+
+    tonosRastreados = numTonos > 0;
+
+    if (alimentaAnalizador)
+    {
+        canalIzqFIFO.update(buffer);
+        canalDerFIFO.update(buffer);
+
+        if (alimentaEstereo)
+        {
+            canalIzqEstereoFIFO.update(buffer);
+            canalDerEstereoFIFO.update(buffer);
+        }
+
+        if (alimentaEstadistica)
+        {
+            canalIzqEstadisticaFIFO.update(buffer);
+            canalDerEstadisticaFIFO.update(buffer);
+        }
+
+        capturaRetroactiva.escribe(buffer, !analizadorAlimentado);
+    }
+
+    analizadorAlimentado = alimentaAnalizador;
+
+    barridoSinusoidal.despuesDeLaCadena(buffer);
+
+    //al final, para medir lo que de verdad sale: con el inserto externo el barrido pone ahi el tono o la excitacion
+    //la sonoridad no depende del editor: la integrada sigue midiendo con el editor cerrado
+    auto midiendoSonoridad = apvts.getRawParameterValue("Medir Sonoridad")->load() > 0.5f;
+
+    if (midiendoSonoridad && !sonoridadMedida)
+    {
+        ponderacionIzq.reset();
+        ponderacionDer.reset();
+        medidorDeSonoridad.reinicia();
+    }
+
+    if (midiendoSonoridad)
+        mideSonoridad(buffer);
 
+    sonoridadMedida = midiendoSonoridad;
 }
 
 //==============================================================================
@@ -248,6 +443,71 @@ ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
     return configs;
 }
 
+ConfiguracionAnalizador getConfiguracionAnalizador(juce::AudioProcessorValueTreeState& apvts)
+{
+    ConfiguracionAnalizador configs;
+
+    configs.suavizado = static_cast<Suavizado>(apvts.getRawParameterValue("Suavizado Analizador")->load());
+    configs.modo = static_cast<ModoAnalizador>(apvts.getRawParameterValue("Modo Analizador")->load());
+    configs.zoomDesde = apvts.getRawParameterValue("Zoom Desde")->load();
+    configs.zoomHasta = apvts.getRawParameterValue("Zoom Hasta")->load();
+
+    configs.promediado = static_cast<ModoPromediado>(apvts.getRawParameterValue("Promediado Analizador")->load());
+    configs.tiempoPromediadoMs = apvts.getRawParameterValue("Tiempo Promediado")->load();
+    configs.framesPromediados = (int)apvts.getRawParameterValue("Frames Promediados")->load();
+    configs.ataqueMs = apvts.getRawParameterValue("Ataque Analizador")->load();
+    configs.liberacionMs = apvts.getRawParameterValue("Liberacion Analizador")->load();
+    configs.retenerPicos = apvts.getRawParameterValue("Retener Picos")->load() > 0.5f;
+    configs.caidaPicosDbPorSegundo = apvts.getRawParameterValue("Caida Picos")->load();
+
+    const std::array<int, 4> picosPorOpcion{ 0, 3, 5, 8 };
+    auto opcionMarcas = juce::jlimit(0, 3, (int)apvts.getRawParameterValue("Marcar Picos")->load());
+    configs.numPicosMarcados = picosPorOpcion[(size_t)opcionMarcas];
+
+    configs.mostrarPreEcualizacion = apvts.getRawParameterValue("Mostrar Pre EQ")->load() > 0.5f;
+    configs.vistaEstereo = static_cast<VistaEstereo>(apvts.getRawParameterValue("Vista Estereo")->load());
+    configs.vistaReferencia = static_cast<VistaReferencia>(apvts.getRawParameterValue("Vista Referencia")->load());
+
+    const std::array<int, 4> ordenPorOpcion{ 0, 12, 14, 16 };
+    auto opcionRetardo = juce::jlimit(0, 3, (int)apvts.getRawParameterValue("Ventana Retardo")->load());
+    configs.ordenVentanaRetardo = ordenPorOpcion[(size_t)opcionRetardo];
+
+    //la banda del zoom nunca puede quedar vacia ni invertida
+    if (configs.zoomHasta < configs.zoomDesde + 1.f)
+        configs.zoomHasta = configs.zoomDesde + 1.f;
+
+    return configs;
+}
+
+int getTonosRastreados(juce::AudioProcessorValueTreeState& apvts, std::array<float, RastreadorDeTonos::maxTonos>& frecuencias)
+{
+    const auto rastreo = (int)apvts.getRawParameterValue("Rastreo de Tonos")->load();
+
+    if (rastreo == RastreoDeTonos::Rastreo_Apagado)
+        return 0;
+
+    int numTonos = 0;
+
+    //el fundamental y los cuatro primeros armonicos, los que suelen sobresalir del zumbido
+    if (rastreo == RastreoDeTonos::Rastreo_Red50 || rastreo == RastreoDeTonos::Rastreo_Red60)
+    {
+        const auto red = rastreo == RastreoDeTonos::Rastreo_Red50 ? 50.f : 60.f;
+
+        for (int armonico = 1; armonico <= 5; ++armonico)
+            frecuencias[(size_t)numTonos++] = red * float(armonico);
+    }
+
+    for (auto* id : idsTonosDeUsuario)
+    {
+        const auto tono = apvts.getRawParameterValue(id)->load();
+
+        if (tono > 0.f && numTonos < RastreadorDeTonos::maxTonos)
+            frecuencias[(size_t)numTonos++] = tono;
+    }
+
+    return numTonos;
+}
+
 Coefficients generadorFiltroPico(const ChainSettings& configuracionesCadena, double sampleRate)
 {
     return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate,
@@ -256,6 +516,69 @@ Coefficients generadorFiltroPico(const ChainSettings& configuracionesCadena, dou
         juce::Decibels::decibelsToGain(configuracionesCadena.volumenPico));
 }
 
+/*
+ BS.1770 gives both stages as 48 kHz coefficients; these are the analog prototypes they
+ come from, so the same curve holds at any sample rate.
+ */
+std::array<Coefficients, 2> generadorPonderacionK(double sampleRate)
+{
+    //estante: +4 dB por encima de ~1.7 kHz
+    const auto K1 = std::tan(juce::MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+    const auto Q1 = 0.7071752369554196;
+    const auto Vh = std::pow(10.0, 3.999843853973347 / 20.0);
+    const auto Vb = std::pow(Vh, 0.4996667741545416);
+
+    const auto estante = new juce::dsp::IIR::Coefficients<float>((float)(Vh + Vb * K1 / Q1 + K1 * K1),
+        (float)(2.0 * (K1 * K1 - Vh)),
+        (float)(Vh - Vb * K1 / Q1 + K1 * K1),
+        (float)(1.0 + K1 / Q1 + K1 * K1),
+        (float)(2.0 * (K1 * K1 - 1.0)),
+        (float)(1.0 - K1 / Q1 + K1 * K1));
+
+    //RLB: paso alto de segundo orden a ~38 Hz; la norma deja el numerador en 1, -2, 1 sin normalizar
+    const auto K2 = std::tan(juce::MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+    const auto Q2 = 0.5003270373238773;
+    const auto a0 = 1.0 + K2 / Q2 + K2 * K2;
+
+    const auto pasoAlto = new juce::dsp::IIR::Coefficients<float>((float)a0,
+        (float)(-2.0 * a0),
+        (float)a0,
+        (float)a0,
+        (float)(2.0 * (K2 * K2 - 1.0)),
+        (float)(1.0 - K2 / Q2 + K2 * K2));
+
+    return { estante, pasoAlto };
+}
+
+void MonitorDeEspectroDeSealAudioProcessor::mideSonoridad(const juce::AudioBuffer<float>& buffer)
+{
+    const auto numCanales = juce::jmin(MedidorDeSonoridad::numCanales, buffer.getNumChannels(), bufferPonderado.getNumChannels());
+    const auto capacidad = bufferPonderado.getNumSamples();
+
+    //si el host manda bloques mas grandes de lo anunciado, a trozos
+    for (int inicio = 0; inicio < buffer.getNumSamples(); inicio += capacidad)
+    {
+        const auto numMuestras = juce::jmin(capacidad, buffer.getNumSamples() - inicio);
+
+        for (int canal = 0; canal < numCanales; ++canal)
+            bufferPonderado.copyFrom(canal, 0, buffer, canal, inicio, numMuestras);
+
+        juce::dsp::AudioBlock<float> block(bufferPonderado);
+        block = block.getSubBlock(0, (size_t)numMuestras);
+
+        auto leftBlock = block.getSingleChannelBlock(0);
+        auto rightBlock = block.getSingleChannelBlock(1);
+
+        juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
+        juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+
+        ponderacionIzq.process(leftContext);
+        ponderacionDer.process(rightContext);
+
+        medidorDeSonoridad.process(bufferPonderado, buffer, inicio, numMuestras);
+    }
+}
+
 void MonitorDeEspectroDeSealAudioProcessor::actualizaFiltroPico(const ChainSettings& configuracionesCadena)
 {
     auto peakCoefficients = generadorFiltroPico(configuracionesCadena, getSampleRate());
@@ -354,6 +677,83 @@ juce::AudioProcessorValueTreeState::ParameterLayout MonitorDeEspectroDeSe
     layout.add(std::make_unique<juce::AudioParameterBool>("Bypass Alto", "Bypass Alto", false));
     layout.add(std::make_unique<juce::AudioParameterBool>("Analizador Activado", "Analizador Activado", true));
 
+    juce::StringArray opcionesSuavizado{ "Sin suavizado", "1/3 Oct", "1/6 Oct", "1/12 Oct", "1/24 Oct" };
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Suavizado Analizador", "Suavizado Analizador", opcionesSuavizado, 0));
+
+    juce::StringArray opcionesModo{ "Normal", "Multirresolucion", "Zoom", "Reasignado", "Transferencia", "Tercios" };
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Modo Analizador", "Modo Analizador", opcionesModo, 0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Zoom Desde",
+        "Zoom Desde",
+        juce::NormalisableRange<float>(20.f, 20000.f, 0.1f, 0.25f),
+        40.f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Zoom Hasta",
+        "Zoom Hasta",
+        juce::NormalisableRange<float>(20.f, 20000.f, 0.1f, 0.25f),
+        80.f));
+
+    juce::StringArray opcionesPromediado{ "Sin promediado", "Exponencial", "Lineal", "Balistica" };
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Promediado Analizador", "Promediado Analizador", opcionesPromediado, 0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Tiempo Promediado",
+        "Tiempo Promediado",
+        juce::NormalisableRange<float>(10.f, 10000.f, 1.f, 0.3f),
+        300.f));
+
+    layout.add(std::make_unique<juce::AudioParameterInt>("Frames Promediados", "Frames Promediados", 2, 64, 8));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Ataque Analizador",
+        "Ataque Analizador",
+        juce::NormalisableRange<float>(1.f, 2000.f, 1.f, 0.3f),
+        10.f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Liberacion Analizador",
+        "Liberacion Analizador",
+        juce::NormalisableRange<float>(10.f, 10000.f, 1.f, 0.3f),
+        500.f));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>("Retener Picos", "Retener Picos", false));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Caida Picos",
+        "Caida Picos",
+        juce::NormalisableRange<float>(0.f, 60.f, 0.1f, 1.f),
+        6.f));
+
+    juce::StringArray opcionesMarcas{ "Sin marcas", "3 picos", "5 picos", "8 picos" };
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Marcar Picos", "Marcar Picos", opcionesMarcas, 0));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>("Mostrar Pre EQ", "Mostrar Pre EQ", false));
+
+    juce::StringArray opcionesEstereo{ "Sin estereo", "Medio/Lado", "Correlacion" };
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Vista Estereo", "Vista Estereo", opcionesEstereo, 0));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>("Medir Sonoridad", "Medir Sonoridad", false));
+
+    juce::StringArray opcionesRetardo{ "Sin retardo", "Retardo 4k", "Retardo 16k", "Retardo 64k" };
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Ventana Retardo", "Ventana Retardo", opcionesRetardo, 0));
+
+    juce::StringArray opcionesTonos{ "Sin tonos", "Zumbido 50 Hz", "Zumbido 60 Hz", "Solo tonos" };
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Rastreo de Tonos", "Rastreo de Tonos", opcionesTonos, 0));
+
+    //0 Hz: libre; se ponen y se quitan con el boton derecho sobre el analizador
+    for (auto* id : idsTonosDeUsuario)
+    {
+        layout.add(std::make_unique<juce::AudioParameterFloat>(id,
+            id,
+            juce::NormalisableRange<float>(0.f, 20000.f, 0.1f, 0.25f),
+            0.f));
+    }
+
+    juce::StringArray opcionesReferencia{ "Sin referencia", "Referencia", "Ref + diferencia" };
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Vista Referencia", "Vista Referencia", opcionesReferencia, 0));
+
+    //al activarla los percentiles y el suelo empiezan de cero
+    layout.add(std::make_unique<juce::AudioParameterBool>("Estadistica Espectral", "Estadistica Espectral", false));
+
+    juce::StringArray opcionesDestinoBarrido{ "Cadena", "Inserto externo" };
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Destino Barrido", "Destino Barrido", opcionesDestinoBarrido, 0));
+
     return layout;
 }
 
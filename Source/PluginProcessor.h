@@ -10,7 +10,14 @@
 
 #include <JuceHeader.h>
 
+#include "PoolDeAnalisis.h"
+#include "CapturaRetroactiva.h"
+#include "BarridoSinusoidal.h"
+#include "MedidorDeSonoridad.h"
+#include "RastreadorDeTonos.h"
+
 #include <array>
+#include <atomic>
 template<typename T>
 struct Fifo
 {
@@ -83,6 +90,15 @@ enum Channel
 template<typename BlockType>
 struct SingleChannelSampleFifo
 {
+    //lo que el hilo de audio sabe de cada buffer al llenarlo
+    struct InfoDelBuffer
+    {
+        float pico = 1.f;
+
+        //orden desde el ultimo reanuda(), cuenta tambien los que no cupieron en el fifo
+        int numero = 0;
+    };
+
     SingleChannelSampleFifo(Channel ch) : channelToUse(ch)
     {
         prepared.set(false);
@@ -100,6 +116,19 @@ struct SingleChannelSampleFifo
         }
     }
 
+    /*
+     called from the audio thread when feeding resumes after a pause: the half filled
+     buffer is dropped and the generation changes, so the reader knows that whatever
+     is still queued is older than the gap and can throw it away.
+     */
+    void reanuda()
+    {
+        fifoIndex = 0;
+        picoDelBuffer = 0.f;
+        numeroDelBuffer = 0;
+        generacion.set(generacion.get() + 1);
+    }
+
     void prepare(int bufferSize)
     {
         prepared.set(false);
@@ -112,34 +141,88 @@ struct SingleChannelSampleFifo
             true);         //avoid reallocating
         audioBufferFifo.prepare(1, bufferSize);
         fifoIndex = 0;
+        picoDelBuffer = 0.f;
+        numeroDelBuffer = 0;
         prepared.set(true);
     }
     //==============================================================================
     int getNumCompleteBuffersAvailable() const { return audioBufferFifo.getNumAvailableForReading(); }
     bool isPrepared() const { return prepared.get(); }
     int getSize() const { return size.get(); }
+    int getGeneracion() const { return generacion.get(); }
     //==============================================================================
-    bool getAudioBuffer(BlockType& buf) { return audioBufferFifo.pull(buf); }
+    bool getAudioBuffer(BlockType& buf)
+    {
+        float picoDescartado;
+        return getAudioBuffer(buf, picoDescartado);
+    }
+
+    /*
+     same, also returning the absolute peak of the buffer, measured on the audio thread
+     while it was filled. lets the analysis skip silent frames without scanning them.
+     */
+    bool getAudioBuffer(BlockType& buf, float& pico)
+    {
+        InfoDelBuffer info;
+        auto ok = getAudioBuffer(buf, info);
+
+        pico = info.pico;
+        return ok;
+    }
+
+    /*
+     same, with the buffer's number too. two fifos that are resumed together in the same
+     block number their buffers alike, so the reader can pair them even if it drained one
+     of them while the audio thread was between the two.
+     */
+    bool getAudioBuffer(BlockType& buf, InfoDelBuffer& info)
+    {
+        if (!audioBufferFifo.pull(buf))
+            return false;
+
+        //la info siempre entra antes que su buffer, asi que ya esta en su fifo
+        if (!infoFifo.pull(info))
+            info = {};
+
+        return true;
+    }
 private:
     Channel channelToUse;
     int fifoIndex = 0;
     Fifo<BlockType> audioBufferFifo;
     BlockType bufferToFill;
+
+    //pico absoluto y numero de cada buffer de audioBufferFifo, en el mismo orden
+    Fifo<InfoDelBuffer> infoFifo;
+    float picoDelBuffer = 0.f;
+    int numeroDelBuffer = 0;
     juce::Atomic<bool> prepared = false;
     juce::Atomic<int> size = 0;
+    juce::Atomic<int> generacion = 0;
 
     void pushNextSampleIntoFifo(float sample)
     {
         if (fifoIndex == bufferToFill.getNumSamples())
         {
-            auto ok = audioBufferFifo.push(bufferToFill);
-
-            juce::ignoreUnused(ok);
+            /*
+             the info goes in first and the buffer only if the info fitted. the reader pulls
+             the buffer first, so the info fifo never holds fewer entries than the buffer fifo
+             and both stay paired.
+             */
+            if (infoFifo.push({ picoDelBuffer, numeroDelBuffer }))
+            {
+                auto ok = audioBufferFifo.push(bufferToFill);
+
+                juce::ignoreUnused(ok);
+            }
 
             fifoIndex = 0;
+            picoDelBuffer = 0.f;
+            ++numeroDelBuffer;
         }
 
         bufferToFill.setSample(0, fifoIndex, sample);
+        picoDelBuffer = juce::jmax(picoDelBuffer, std::abs(sample));
         ++fifoIndex;
     }
 };
@@ -164,6 +247,107 @@ struct ChainSettings
 
 ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
 
+enum Suavizado
+{
+    Suavizado_Ninguno,
+    Suavizado_3,
+    Suavizado_6,
+    Suavizado_12,
+    Suavizado_24
+};
+
+//fraccion de octava del suavizado (3 -> 1/3 oct), 0 si no se suaviza
+inline int getFraccionDeOctava(Suavizado suavizado)
+{
+    switch (suavizado)
+    {
+    case Suavizado_3: return 3;
+    case Suavizado_6: return 6;
+    case Suavizado_12: return 12;
+    case Suavizado_24: return 24;
+    case Suavizado_Ninguno: break;
+    }
+
+    return 0;
+}
+
+enum ModoAnalizador
+{
+    Modo_Normal,
+    Modo_MultiResolucion,
+    Modo_Zoom,
+    Modo_Reasignado,
+    Modo_Transferencia,
+    Modo_Tercios
+};
+
+//vistas de la imagen estereo que se pueden superponer al analizador
+enum VistaEstereo
+{
+    Estereo_Apagado,
+    Estereo_MedioLado,
+    Estereo_Correlacion
+};
+
+//lo que se dibuja de la pista de referencia que llega por el sidechain
+enum VistaReferencia
+{
+    Referencia_Apagada,
+    Referencia_Espectro,
+    Referencia_ConDiferencia
+};
+
+//frecuencias que sigue el RastreadorDeTonos: el zumbido de la red con sus armonicos, mas los tonos del usuario
+enum RastreoDeTonos
+{
+    Rastreo_Apagado,
+    Rastreo_Red50,
+    Rastreo_Red60,
+    Rastreo_SoloTonos
+};
+
+//los tonos que fija el usuario, a 0 Hz estan libres
+constexpr std::array<const char*, 3> idsTonosDeUsuario{ "Tono 1", "Tono 2", "Tono 3" };
+
+enum ModoPromediado
+{
+    Promediado_Ninguno,
+    Promediado_Exponencial,
+    Promediado_Lineal,
+    Promediado_Balistica
+};
+
+struct ConfiguracionAnalizador
+{
+    Suavizado suavizado{ Suavizado::Suavizado_Ninguno };
+    ModoAnalizador modo{ ModoAnalizador::Modo_Normal };
+    float zoomDesde{ 40.f }, zoomHasta{ 80.f };
+
+    ModoPromediado promediado{ ModoPromediado::Promediado_Ninguno };
+    float tiempoPromediadoMs{ 300.f };
+    int framesPromediados{ 8 };
+    float ataqueMs{ 10.f }, liberacionMs{ 500.f };
+
+    bool retenerPicos{ false };
+    float caidaPicosDbPorSegundo{ 6.f };
+
+    int numPicosMarcados{ 0 };
+
+    bool mostrarPreEcualizacion{ false };
+
+    VistaEstereo vistaEstereo{ VistaEstereo::Estereo_Apagado };
+
+    VistaReferencia vistaReferencia{ VistaReferencia::Referencia_Apagada };
+
+    //ventana de la estimacion del retardo entre canales, 2^orden muestras; 0 la apaga
+    int ordenVentanaRetardo{ 0 };
+};
+
+ConfiguracionAnalizador getConfiguracionAnalizador(juce::AudioProcessorValueTreeState& apvts);
+
+//escribe las frecuencias que hay que rastrear y devuelve cuantas son, 0 con el rastreo apagado
+int getTonosRastreados(juce::AudioProcessorValueTreeState& apvts, std::array<float, RastreadorDeTonos::maxTonos>& frecuencias);
+
 using Filter = juce::dsp::IIR::Filter<float>;
 
 using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
@@ -182,6 +366,10 @@ void updateCoefficients(Coefficients& old, const Coefficients& replacements);
 
 Coefficients generadorFiltroPico(const ChainSettings& configuracionesCadena, double sampleRate);
 
+//ponderacion K de BS.1770: el estante de +4 dB que imita la cabeza y el paso alto RLB
+using PonderacionK = juce::dsp::ProcessorChain<Filter, Filter>;
+std::array<Coefficients, 2> generadorPonderacionK(double sampleRate);
+
 template<int Index, typename ChainType, typename CoefficientType>
 void update(ChainType& chain, const CoefficientType& coefficients)
 {
@@ -282,9 +470,66 @@ public:
     using BlockType = juce::AudioBuffer<float>;
     SingleChannelSampleFifo<BlockType> canalIzqFIFO{ Channel::Left };
     SingleChannelSampleFifo<BlockType> canalDerFIFO{ Channel::Right };
+
+    //la entrada antes de los filtros, solo se llenan con la traza pre EQ activada
+    SingleChannelSampleFifo<BlockType> canalIzqPreFIFO{ Channel::Left };
+    SingleChannelSampleFifo<BlockType> canalDerPreFIFO{ Channel::Right };
+
+    //copia de la salida para la imagen estereo, solo se llenan con una vista estereo activada
+    SingleChannelSampleFifo<BlockType> canalIzqEstereoFIFO{ Channel::Left };
+    SingleChannelSampleFifo<BlockType> canalDerEstereoFIFO{ Channel::Right };
+
+    //la entrada, antes de los filtros, para el retardo entre canales; solo se llenan con la estimacion activada
+    SingleChannelSampleFifo<BlockType> canalIzqRetardoFIFO{ Channel::Left };
+    SingleChannelSampleFifo<BlockType> canalDerRetardoFIFO{ Channel::Right };
+
+    //copia de la salida para los percentiles y el suelo de ruido, solo se llenan con la estadistica activada
+    SingleChannelSampleFifo<BlockType> canalIzqEstadisticaFIFO{ Channel::Left };
+    SingleChannelSampleFifo<BlockType> canalDerEstadisticaFIFO{ Channel::Right };
+
+    //la pista de referencia del sidechain, solo se analiza; se llenan con la referencia activada y el bus conectado
+    SingleChannelSampleFifo<BlockType> canalIzqReferenciaFIFO{ Channel::Left };
+    SingleChannelSampleFifo<BlockType> canalDerReferenciaFIFO{ Channel::Right };
+
+    //los ultimos segundos de lo que recibe el analizador, para congelarlos y reanalizarlos
+    CapturaRetroactiva capturaRetroactiva;
+
+    //medida de la cadena o de un equipo externo con barrido, ver BarridoSinusoidal.h
+    BarridoSinusoidal barridoSinusoidal;
+
+    //sonoridad y pico verdadero de lo que sale del plugin, tono o barrido incluidos, solo mientras "Medir Sonoridad" esta activado
+    MedidorDeSonoridad medidorDeSonoridad;
+
+    //niveles de la red y de tonos concretos en la salida, solo con un editor abierto
+    RastreadorDeTonos rastreadorDeTonos;
+
+    //lo que vuelve del tono de prueba, solo se llena mientras suena
+    SingleChannelSampleFifo<BlockType> canalDistorsionFIFO{ Channel::Left };
+
+    //compartido por todas las instancias del proceso, ver PoolDeAnalisis.h
+    juce::SharedResourcePointer<PoolDeAnalisis> poolDeAnalisis;
+
+    //los fifos del analizador solo se llenan mientras haya algun consumidor (un editor abierto)
+    void conectaConsumidorDelAnalizador() { ++consumidoresDelAnalizador; }
+    void desconectaConsumidorDelAnalizador() { --consumidoresDelAnalizador; }
+
+    //el bus de referencia es opcional, el host puede dejarlo desactivado
+    bool tieneEntradaDeReferencia() const { return getChannelCountOfBus(true, 1) > 0; }
 private:
+    std::atomic<int> consumidoresDelAnalizador{ 0 };
+
+    //solo lo toca el hilo de audio
+    bool analizadorAlimentado = false, preEcualizacionAlimentada = false, distorsionAlimentada = false;
+    bool estereoAlimentado = false, retardoAlimentado = false, sonoridadMedida = false, tonosRastreados = false;
+    bool estadisticaAlimentada = false, referenciaAlimentada = false;
+
     MonoChain cadenaIzq, cadenaDer;
 
+    //la ponderacion K no toca la salida: filtra una copia reservada en prepareToPlay
+    PonderacionK ponderacionIzq, ponderacionDer;
+    juce::AudioBuffer<float> bufferPonderado;
+    void mideSonoridad(const juce::AudioBuffer<float>& buffer);
+
     void actualizaFiltroPico(const ChainSettings& configuracionesCadena);
 
 
@@ -294,8 +539,6 @@ private:
     void actualizaFiltroAlto(const ChainSettings& configuracionesCadena);
 
     void actualizaFiltros();
-
-    juce::dsp::Oscillator<float> osc;
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MonitorDeEspectroDeSealAudioProcessor)
 };
\ No newline at end of file
@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+    PoolDeAnalisis.cpp
+
+  ==============================================================================
+*/
+
+#include "PoolDeAnalisis.h"
+
+PoolDeAnalisis::PoolDeAnalisis()
+{
+    //dejamos al menos un nucleo libre para el audio y el hilo de mensajes
+    auto numHilos = juce::jlimit(1, 4, juce::SystemStats::getNumCpus() - 1);
+
+    for (int i = 0; i < numHilos; ++i)
+    {
+        auto* hilo = hilos.add(new Hilo(*this, i));
+        hilo->startThread();
+    }
+}
+
+PoolDeAnalisis::~PoolDeAnalisis()
+{
+    for (auto* hilo : hilos)
+        hilo->signalThreadShouldExit();
+
+    hayEntradas.signal();
+
+    for (auto* hilo : hilos)
+    {
+        hayTrabajo.signal();
+        hilo->stopThread(1000);
+    }
+
+    //cada editor tiene que haber eliminado sus trabajos antes de irse
+    jassert(entradas.empty());
+}
+
+void PoolDeAnalisis::registra(TrabajoDeAnalisis& trabajo)
+{
+    const juce::ScopedLock sl(lock);
+
+    jassert(std::none_of(entradas.begin(), entradas.end(),
+        [&trabajo](const Entrada& e) { return e.trabajo == &trabajo; }));
+
+    entradas.push_back({ &trabajo, false });
+
+    hayEntradas.signal();
+    hayTrabajo.signal();
+}
+
+void PoolDeAnalisis::elimina(TrabajoDeAnalisis& trabajo)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (;;)
+    {
+        auto it = std::find_if(entradas.begin(), entradas.end(),
+            [&trabajo](const Entrada& e) { return e.trabajo == &trabajo; });
+
+        if (it == entradas.end())
+            return;
+
+        if (!it->enCurso)
+        {
+            entradas.erase(it);
+
+            if (entradas.empty())
+                hayEntradas.reset();
+
+            return;
+        }
+
+        const juce::ScopedUnlock su(lock);
+        trabajoTerminado.wait(intervaloDeSondeoMs);
+    }
+}
+
+TrabajoDeAnalisis* PoolDeAnalisis::tomaSiguienteTrabajo()
+{
+    const juce::ScopedLock sl(lock);
+
+    const auto numEntradas = entradas.size();
+    Entrada* elegida = nullptr;
+
+    //recorremos en round-robin para que los trabajos de igual prioridad se repartan
+    for (size_t n = 0; n < numEntradas; ++n)
+    {
+        auto& e = entradas[(siguienteEntrada + n) % numEntradas];
+
+        if (e.enCurso || !e.trabajo->hayTrabajoPendiente())
+            continue;
+
+        if (elegida == nullptr || e.trabajo->getPrioridad() > elegida->trabajo->getPrioridad())
+            elegida = &e;
+    }
+
+    if (elegida == nullptr)
+        return nullptr;
+
+    siguienteEntrada = size_t(elegida - entradas.data()) + 1;
+    elegida->enCurso = true;
+    return elegida->trabajo;
+}
+
+void PoolDeAnalisis::terminaTrabajo(TrabajoDeAnalisis* trabajo)
+{
+    {
+        const juce::ScopedLock sl(lock);
+
+        for (auto& e : entradas)
+        {
+            if (e.trabajo == trabajo)
+                e.enCurso = false;
+        }
+    }
+
+    trabajoTerminado.signal();
+}
+
+void PoolDeAnalisis::bucleDeTrabajo(juce::Thread& hilo)
+{
+    while (!hilo.threadShouldExit())
+    {
+        if (auto* trabajo = tomaSiguienteTrabajo())
+        {
+            trabajo->ejecuta();
+            terminaTrabajo(trabajo);
+        }
+        else
+        {
+            //sin editores abiertos no hay nada que sondear, se duerme hasta el proximo registra()
+            hayEntradas.wait(-1);
+            hayTrabajo.wait(intervaloDeSondeoMs);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    PoolDeAnalisis.h
+
+    Pool de hilos compartido por todas las instancias del plugin en el proceso.
+    Los procesadores lo mantienen vivo a traves de juce::SharedResourcePointer,
+    asi que solo existe mientras haya al menos una instancia cargada.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+#include <vector>
+
+/**
+ Trabajo recurrente que el pool ejecuta cada vez que tiene datos pendientes.
+ El pool garantiza que un mismo trabajo nunca corre en dos hilos a la vez.
+ */
+struct TrabajoDeAnalisis
+{
+    virtual ~TrabajoDeAnalisis() = default;
+
+    //se llama con el lock del pool tomado, tiene que ser barato
+    virtual bool hayTrabajoPendiente() = 0;
+    virtual void ejecuta() = 0;
+
+    //los trabajos con mas prioridad (editores visibles) se atienden antes
+    void setPrioridad(int nuevaPrioridad) { prioridad.store(nuevaPrioridad); }
+    int getPrioridad() const { return prioridad.load(); }
+private:
+    std::atomic<int> prioridad{ 0 };
+};
+
+class PoolDeAnalisis
+{
+public:
+    PoolDeAnalisis();
+    ~PoolDeAnalisis();
+
+    void registra(TrabajoDeAnalisis& trabajo);
+
+    //bloquea hasta que el trabajo haya terminado si estaba en curso
+    void elimina(TrabajoDeAnalisis& trabajo);
+
+    //despierta a un hilo dormido; mientras haya trabajos registrados los hilos tambien sondean cada pocos ms
+    void notifica() { hayTrabajo.signal(); }
+
+    int getNumHilos() const { return hilos.size(); }
+private:
+    struct Hilo : juce::Thread
+    {
+        Hilo(PoolDeAnalisis& p, int indice) :
+            juce::Thread("Analisis " + juce::String(indice)),
+            pool(p)
+        {
+        }
+
+        void run() override { pool.bucleDeTrabajo(*this); }
+    private:
+        PoolDeAnalisis& pool;
+    };
+
+    struct Entrada
+    {
+        TrabajoDeAnalisis* trabajo = nullptr;
+        bool enCurso = false;
+    };
+
+    TrabajoDeAnalisis* tomaSiguienteTrabajo();
+    void terminaTrabajo(TrabajoDeAnalisis* trabajo);
+    void bucleDeTrabajo(juce::Thread& hilo);
+
+    static constexpr int intervaloDeSondeoMs = 5;
+
+    juce::CriticalSection lock;
+    std::vector<Entrada> entradas;
+    size_t siguienteEntrada = 0;
+
+    juce::WaitableEvent hayTrabajo, trabajoTerminado;
+
+    //sealado mientras haya alguna entrada; sin ninguna los hilos duermen sin sondear
+    juce::WaitableEvent hayEntradas{ true };
+    juce::OwnedArray<Hilo> hilos;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PoolDeAnalisis)
+};
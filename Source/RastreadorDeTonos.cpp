@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+    RastreadorDeTonos.cpp
+
+  ==============================================================================
+*/
+
+#include "RastreadorDeTonos.h"
+
+void RastreadorDeTonos::prepare(double sampleRate)
+{
+    frecuencia = sampleRate;
+
+    //el redondeo a periodos enteros alarga la ventana como mucho medio periodo de la frecuencia minima
+    const auto capacidad = (size_t)std::ceil(sampleRate * (duracionVentana + 0.5 / double(frecuenciaMinima))) + 1;
+
+    for (auto& tono : tonos)
+    {
+        for (auto& anillo : tono.anillo)
+            anillo.assign(capacidad, {});
+
+        //a otra frecuencia de muestreo la misma frecuencia es otro tono
+        tono.frecuencia = 0.f;
+        tono.longitud = 0;
+    }
+
+    numTonos = 0;
+    reinicia();
+}
+
+void RastreadorDeTonos::reinicia()
+{
+    for (int t = 0; t < numTonos; ++t)
+        preparaTono(tonos[(size_t)t], tonos[(size_t)t].frecuencia);
+
+    publica();
+}
+
+void RastreadorDeTonos::setFrecuencias(const float* frecuencias, int nuevosTonos)
+{
+    nuevosTonos = juce::jlimit(0, maxTonos, nuevosTonos);
+
+    for (int t = 0; t < nuevosTonos; ++t)
+        if (t >= numTonos || tonos[(size_t)t].frecuencia != frecuencias[t])
+            preparaTono(tonos[(size_t)t], frecuencias[t]);
+
+    numTonos = nuevosTonos;
+}
+
+void RastreadorDeTonos::preparaTono(Tono& tono, float nuevaFrecuencia)
+{
+    tono.frecuencia = nuevaFrecuencia;
+    tono.longitud = 0;
+    tono.posicion = 0;
+    tono.llenas = 0;
+    tono.suma.fill({});
+
+    if (nuevaFrecuencia < frecuenciaMinima || nuevaFrecuencia > 0.45 * frecuencia)
+        return;
+
+    const auto ciclos = juce::jmax(1.0, std::round(double(nuevaFrecuencia) * duracionVentana));
+    tono.longitud = juce::jlimit(1, (int)tono.anillo[0].size(), juce::roundToInt(ciclos * frecuencia / double(nuevaFrecuencia)));
+
+    tono.fasor = { 1.0, 0.0 };
+    tono.rotacion = std::polar(1.0, -juce::MathConstants<double>::twoPi * double(nuevaFrecuencia) / frecuencia);
+
+    for (auto& anillo : tono.anillo)
+        std::fill(anillo.begin(), anillo.begin() + tono.longitud, std::complex<float>{});
+}
+
+void RastreadorDeTonos::process(const juce::AudioBuffer<float>& buffer)
+{
+    const auto canales = juce::jmin(numCanales, buffer.getNumChannels());
+    const auto numMuestras = buffer.getNumSamples();
+
+    for (int t = 0; t < numTonos; ++t)
+    {
+        auto& tono = tonos[(size_t)t];
+
+        if (tono.longitud == 0)
+            continue;
+
+        for (int c = 0; c < canales; ++c)
+        {
+            const auto* x = buffer.getReadPointer(c);
+            auto* anillo = tono.anillo[(size_t)c].data();
+            auto suma = tono.suma[(size_t)c];
+            auto fasor = tono.fasor;
+            auto posicion = tono.posicion;
+
+            for (int i = 0; i < numMuestras; ++i)
+            {
+                //se guarda en float y se suma lo mismo que se restara al salir de la ventana
+                const auto entra = std::complex<float>(fasor * double(x[i]));
+
+                suma += std::complex<double>(entra) - std::complex<double>(anillo[posicion]);
+                anillo[posicion] = entra;
+
+                fasor *= tono.rotacion;
+
+                if (++posicion == tono.longitud)
+                    posicion = 0;
+            }
+
+            tono.suma[(size_t)c] = suma;
+
+            //el ultimo canal deja el fasor y la posicion para el bloque siguiente
+            if (c == canales - 1)
+            {
+                tono.fasor = fasor / std::abs(fasor);
+                tono.posicion = posicion;
+            }
+        }
+
+        tono.llenas = juce::jmin(tono.longitud, tono.llenas + numMuestras);
+    }
+
+    publica();
+}
+
+void RastreadorDeTonos::publica()
+{
+    for (int t = 0; t < maxTonos; ++t)
+    {
+        const auto& tono = tonos[(size_t)t];
+        const auto medido = t < numTonos && tono.longitud > 0 && tono.llenas == tono.longitud;
+
+        frecuenciasPublicadas[(size_t)t].store(tono.frecuencia);
+
+        for (int c = 0; c < numCanales; ++c)
+        {
+            //un seno de amplitud A deja |suma| = A N / 2
+            const auto amplitud = 2.0 * std::abs(tono.suma[(size_t)c]) / double(juce::jmax(1, tono.longitud));
+
+            niveles[(size_t)c][(size_t)t].store(medido ? juce::Decibels::gainToDecibels((float)amplitud, sinMedida) : sinMedida);
+        }
+    }
+
+    tonosPublicados.store(numTonos);
+}
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    RastreadorDeTonos.h
+
+    Nivel de unas pocas frecuencias fijas (el zumbido de la red y sus
+    armonicos, o tonos conocidos) en el hilo de audio, sin reservar memoria
+    despues de prepare().
+
+    Cada tono es una DFT deslizante de un solo bin a su frecuencia exacta:
+    la suma de x[n] e^(-j w n) en una ventana rectangular de N muestras se
+    actualiza en cada muestra sumando la que entra y restando la que sale,
+    guardada en un anillo. Cuesta unas pocas multiplicaciones por muestra y
+    tono, y el nivel esta al dia al final de cada bloque de audio.
+
+    N se elige para que la ventana tenga un numero entero de periodos del
+    tono (unos 100 ms), asi los armonicos del mismo zumbido caen en los
+    ceros de la ventana y no se cuelan en el nivel de los demas.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+#include <complex>
+#include <vector>
+
+struct RastreadorDeTonos
+{
+    static constexpr int numCanales = 2;
+    static constexpr int maxTonos = 8;
+
+    //lo que se publica mientras no hay medida
+    static constexpr float sinMedida = -200.f;
+
+    //por debajo no hay periodos enteros en la ventana sin alargarla mucho
+    static constexpr float frecuenciaMinima = 20.f;
+    static constexpr double duracionVentana = 0.1;
+
+    //fuera del hilo de audio (prepareToPlay), reserva los anillos para la ventana mas larga
+    void prepare(double sampleRate);
+
+    //hilo de audio: olvida todas las medidas
+    void reinicia();
+
+    /*
+     audio thread. only the tones whose frequency changed start over; frequencies outside
+     frecuenciaMinima ... 0.45 fs are kept in their slot but not measured.
+     */
+    void setFrecuencias(const float* frecuencias, int numTonos);
+
+    void process(const juce::AudioBuffer<float>& buffer);
+
+    //cualquier hilo; la amplitud de pico de cada tono en dBFS, como la traza (un seno de amplitud 1 da 0 dB)
+    int getNumTonos() const { return tonosPublicados.load(); }
+    float getFrecuencia(int tono) const { return frecuenciasPublicadas[(size_t)tono].load(); }
+    float getNivel(int canal, int tono) const { return niveles[(size_t)canal][(size_t)tono].load(); }
+private:
+    struct Tono
+    {
+        float frecuencia = 0.f;
+        int longitud = 0;   //0: fuera de rango, no se mide
+
+        std::complex<double> fasor{ 1.0, 0.0 }, rotacion{ 1.0, 0.0 };
+
+        //la suma se lleva en doble y se le resta exactamente lo que se le sumo, no deriva
+        std::array<std::complex<double>, numCanales> suma{};
+        std::array<std::vector<std::complex<float>>, numCanales> anillo;
+        int posicion = 0, llenas = 0;
+    };
+
+    void preparaTono(Tono& tono, float nuevaFrecuencia);
+    void publica();
+
+    double frecuencia = 48000.0;
+
+    std::array<Tono, maxTonos> tonos;
+    int numTonos = 0;
+
+    std::atomic<int> tonosPublicados{ 0 };
+    std::array<std::atomic<float>, maxTonos> frecuenciasPublicadas{};
+    std::array<std::array<std::atomic<float>, maxTonos>, numCanales> niveles{};
+};